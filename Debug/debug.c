@@ -170,9 +170,10 @@ void SDI_Printf_Enable(void)
 __attribute__((used)) 
 int _write(int fd, char *buf, int size)
 {
-    int i = 0;
     int writeSize = size;
 #if (SDI_PRINT == SDI_PR_OPEN)
+    int i = 0;
+
     do
     {
 
@@ -205,7 +206,16 @@ int _write(int fd, char *buf, int size)
 
     } while (writeSize);
 
+#elif (SDI_PRINT == SDI_PR_SOFT)
+
+    writeSize = softuart_write(buf, size);
+
+#elif (SDI_PRINT == SDI_PR_NONE)
+
+    (void) buf;
+
 #else
+    int i;
 
     for(i = 0; i < size; i++){
         while(USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET);
@@ -34,16 +34,23 @@
 /* SDI Printf Definition */
 #define SDI_PR_CLOSE   0
 #define SDI_PR_OPEN    1
+#define SDI_PR_SOFT    2  // software UART, see User/softuart.h
+#define SDI_PR_NONE    3  // no debug output, printf() & its strings are left out of flash
 
 #ifndef SDI_PRINT
 #define SDI_PRINT   SDI_PR_OPEN
 #endif
 
+#if (SDI_PRINT == SDI_PR_NONE)
+#define printf(...) ((void) 0)
+#endif
+
 void Delay_Init(void);
 void Delay_Us(uint32_t n);
 void Delay_Ms(uint32_t n);
 void USART_Printf_Init(uint32_t baudrate);
 void SDI_Printf_Enable(void);
+int softuart_write(char *buf, int size);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+Generate User/durations_gen.c from SD card contents
+
+Scans SD_ROOT/FF/TTT*.mp3 (folders 01..99, tracks 001..255) and measures every
+track from its MPEG frames, no external packages:
+  - Xing/Info or VBRI header gives exact frame count (VBR & LAME CBR files)
+  - otherwise frames are walked header to header
+
+Storage: sorted (folder << 8 | track) keys & seconds, looked up by User/position.c
+
+Usage: python3 Tools/durationgen.py [SD_ROOT]   (without SD_ROOT an empty table is written)
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUTPUT = os.path.join(ROOT, "User", "durations_gen.c")
+
+# bitrate kbps by [version is MPEG1][layer index], layer index 1 = III, 2 = II, 3 = I
+BITRATES = {
+    (True, 3): [0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448],
+    (True, 2): [0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384],
+    (True, 1): [0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320],
+    (False, 3): [0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256],
+    (False, 2): [0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160],
+    (False, 1): [0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160],
+}
+SAMPLE_RATES = {3: [44100, 48000, 32000], 2: [22050, 24000, 16000], 0: [11025, 12000, 8000]}
+
+
+def header(data, pos):
+    """Decode MPEG audio frame header, returns (frame size, samples, sample rate, side info) or None"""
+    if pos + 4 > len(data) or data[pos] != 0xFF or (data[pos + 1] & 0xE0) != 0xE0:
+        return None
+    version = (data[pos + 1] >> 3) & 3
+    layer = (data[pos + 1] >> 1) & 3
+    bitrate_index = data[pos + 2] >> 4
+    rate_index = (data[pos + 2] >> 2) & 3
+    if version == 1 or layer == 0 or bitrate_index in (0, 15) or rate_index == 3:
+        return None
+    mpeg1 = version == 3
+    bitrate = BITRATES[(mpeg1, layer)][bitrate_index] * 1000
+    rate = SAMPLE_RATES[version][rate_index]
+    padding = (data[pos + 2] >> 1) & 1
+    mono = (data[pos + 3] >> 6) == 3
+    if layer == 3:
+        samples, size = 384, (12 * bitrate // rate + padding) * 4
+    elif layer == 2 or mpeg1:
+        samples, size = 1152, 144 * bitrate // rate + padding
+    else:
+        samples, size = 576, 72 * bitrate // rate + padding
+    side = (17 if mono else 32) if mpeg1 else (9 if mono else 17)
+    return size, samples, rate, side
+
+
+def duration(path):
+    data = open(path, "rb").read()
+    pos = 0
+    if data[:3] == b"ID3" and len(data) > 10:
+        pos = 10 + ((data[6] << 21) | (data[7] << 14) | (data[8] << 7) | data[9])
+
+    # first frame, skip garbage between tag & audio
+    while pos < len(data) and header(data, pos) is None:
+        pos += 1
+    first = header(data, pos)
+    if first is None:
+        return 0
+    size, samples, rate, side = first
+
+    # VBR headers sit in first frame
+    tag = pos + 4 + side
+    if data[tag:tag + 4] in (b"Xing", b"Info") and data[tag + 7] & 1:
+        frames = int.from_bytes(data[tag + 8:tag + 12], "big")
+        return round(frames * samples / rate)
+    if data[pos + 36:pos + 40] == b"VBRI":
+        frames = int.from_bytes(data[pos + 50:pos + 54], "big")
+        return round(frames * samples / rate)
+
+    total = 0
+    while True:
+        frame = header(data, pos)
+        if frame is None or frame[0] == 0:
+            break
+        total += frame[1] / frame[2]
+        pos += frame[0]
+    return round(total)
+
+
+def scan(sd_root):
+    durations = {}
+    for folder_name in sorted(os.listdir(sd_root)):
+        if not re.fullmatch(r"\d{2}", folder_name) or not 1 <= int(folder_name) <= 99:
+            continue
+        folder_path = os.path.join(sd_root, folder_name)
+        for name in sorted(os.listdir(folder_path)):
+            m = re.match(r"(\d{3}).*\.mp3$", name, re.IGNORECASE)
+            if not m or not 1 <= int(m.group(1)) <= 255:
+                continue
+            seconds = min(duration(os.path.join(folder_path, name)), 0xFFFF)
+            durations[(int(folder_name) << 8) | int(m.group(1))] = seconds
+    return dict(sorted(durations.items()))
+
+
+def main():
+    durations = scan(sys.argv[1]) if len(sys.argv) > 1 else {}
+
+    out = []
+    out.append("/*")
+    out.append("   Generated by Tools/durationgen.py, DON'T EDIT")
+    out.append("   Source: %s, %d tracks" % ("SD card" if durations else "none", len(durations)))
+    out.append("*/")
+    out.append("")
+    out.append("#include <stdio.h>")
+    out.append("#include \"position.h\"")
+    out.append("")
+    out.append("const uint16_t durationCount = %d;" % len(durations))
+    out.append("")
+    out.append("const uint16_t durationKeys[%d] = {" % max(len(durations), 1))
+    keys = list(durations)
+    for i in range(0, len(keys), 12):
+        out.append("  %s," % ", ".join("0x%04X" % k for k in keys[i:i + 12]))
+    if not keys:
+        out.append("  0")
+    out.append("};")
+    out.append("")
+    out.append("const uint16_t durationSeconds[%d] = {" % max(len(durations), 1))
+    values = list(durations.values())
+    for i in range(0, len(values), 12):
+        out.append("  %s," % ", ".join(str(v) for v in values[i:i + 12]))
+    if not values:
+        out.append("  0")
+    out.append("};")
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+
+    print("%s: %d tracks, %d bytes in flash" % (os.path.relpath(OUTPUT, ROOT), len(durations), len(durations) * 4 + 2))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""
+Generate User/fonts_gen.c from Tools/font8x8_basic.h & Tools/font8x8_ext.txt
+
+Only glyphs referenced by display strings in User/*.c are emitted:
+  - string literals outside printf() lines, UTF-8
+  - format strings contribute their literal characters, numeric conversions add digits
+  - track titles from Tools/titles.txt
+
+Tables:
+  - font8x8[]      fixed 8x8 subset, ASCII first, indexed via fontMap[ch - 0x20]
+  - fontWideKeys[] sorted code points of non-ASCII glyphs, glyph index = fontWideBase + position
+  - fontProp*      same subset with empty columns trimmed, for proportional text
+  - font2x[]       16x16 digits, pre-stretched into two SSD1306 pages
+
+Usage: python3 Tools/fontgen.py   (run from repo root or anywhere, rerun when UI strings change)
+"""
+
+import codecs
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(ROOT, "Tools", "font8x8_basic.h")
+EXTRA = os.path.join(ROOT, "Tools", "font8x8_ext.txt")
+OUTPUT = os.path.join(ROOT, "User", "fonts_gen.c")
+TITLES = os.path.join(ROOT, "Tools", "titles.txt")
+
+ALWAYS = " ?"                # space & fallback for missing glyphs
+FONT2X = "0123456789"         # 2x scaled readout glyphs, others are drawn blank
+MISSING = 0xFF
+MAX_GLYPHS = 0xFF            # glyph index is uint8_t, 0xFF marks missing
+
+# accents as (column offset from glyph center, row), placed in rows 0..1 above glyph
+MARKS = {
+    "grave": [(-1, 0), (0, 1)],
+    "acute": [(1, 0), (0, 1)],
+    "circumflex": [(0, 0), (-1, 1), (1, 1)],
+    "tilde": [(-1, 1), (0, 0), (1, 1), (2, 0)],
+    "diaeresis": [(-1, 0), (2, 0)],
+    "ring": [(0, 0), (1, 0), (0, 1), (1, 1)],
+    "breve": [(-1, 0), (0, 1), (1, 1), (2, 0)],
+}
+
+LITERAL = re.compile(r'"((?:[^"\\]|\\.)*)"')
+CONVERSION = re.compile(r"%[-+ #0]*(\d+|\*)?(\.\d+)?(l|h)*([diouxXcs%])")
+
+
+def load_font():
+    glyphs = {}
+    for line in open(SOURCE, encoding="utf-8"):
+        m = re.search(r"\{([^}]*)\}.*U\+([0-9A-Fa-f]{4})", line)
+        if m:
+            glyphs[int(m.group(2), 16)] = [int(v, 16) for v in m.group(1).split(",")]
+    load_extra(glyphs)
+    return glyphs
+
+
+def to_rows(columns):
+    return [sum(((columns[x] >> y) & 1) << x for x in range(8)) for y in range(8)]
+
+
+def to_columns(rows):
+    return [sum(((rows[y] >> x) & 1) << y for y in range(8)) for x in range(8)]
+
+
+def squeeze(rows):
+    """Drop one row of 7 row capital, the adjacent pair that differs least is merged"""
+    pairs = [(bin(rows[y] ^ rows[y + 1]).count("1"), abs(3 - y), y) for y in range(1, 5)]
+    y = min(pairs)[2]
+    return rows[:y] + [rows[y] | rows[y + 1]] + rows[y + 2:7]
+
+
+def compose(columns, mark):
+    rows = to_rows(columns)
+    if mark == "flip":
+        return to_columns(rows[6::-1] + [rows[7]])
+    ink = [x for x in range(8) if columns[x]]
+    center = (ink[0] + ink[-1]) // 2
+    if mark == "cedilla":
+        if rows[7]:
+            raise SystemExit("%s: cedilla needs empty bottom row" % EXTRA)
+        return to_columns(rows[:7] + [(1 << center) | (1 << (center - 1))])
+    if rows[1]:
+        rows = [0, 0] + squeeze(rows)   # capital, 6 rows below the mark
+    else:
+        rows = [0, 0] + rows[2:]        # small letter, dot of i dropped
+    for dx, y in MARKS[mark]:
+        rows[y] |= 1 << (center + dx)
+    return to_columns(rows)
+
+
+def load_extra(glyphs):
+    lines = [line.rstrip() for line in open(EXTRA, encoding="utf-8")]
+    lines = [line for line in lines if line and not line.startswith("#")]
+    i = 0
+    while i < len(lines):
+        m = re.match(r"U\+([0-9A-Fa-f]{4})(?:\s*=\s*U\+([0-9A-Fa-f]{4})(?:\s+(\w+))?)?$", lines[i])
+        if not m:
+            raise SystemExit("%s: unexpected '%s'" % (EXTRA, lines[i]))
+        code = int(m.group(1), 16)
+        if m.group(2):
+            base = glyphs[int(m.group(2), 16)]
+            glyphs[code] = compose(base, m.group(3)) if m.group(3) else list(base)
+            i += 1
+            continue
+        art = lines[i + 1:i + 9]
+        if len(art) != 8 or any(len(row) != 8 or set(row) - set(".X") for row in art):
+            raise SystemExit("%s: U+%04X needs 8 rows of 8 '.'/'X'" % (EXTRA, code))
+        glyphs[code] = to_columns([sum(1 << x for x in range(8) if row[x] == "X") for row in art])
+        i += 9
+
+
+def printable(c, glyphs):
+    if ord(c) < 0x80:
+        return 0x20 <= ord(c) < 0x7F
+    if ord(c) not in glyphs:
+        print("warning: no glyph for U+%04X (%s), drawn as '?'" % (ord(c), c))
+        return False
+    return True
+
+
+def referenced(glyphs):
+    chars = set(ALWAYS)
+    user = os.path.join(ROOT, "User")
+    if os.path.exists(TITLES):
+        for line in open(TITLES, encoding="utf-8"):
+            line = line.split("#", 1)[0].strip()
+            chars.update(c for c in line.partition(" ")[2] if printable(c, glyphs))
+    for name in sorted(os.listdir(user)):
+        if not name.endswith(".c") or name.endswith("_gen.c"):
+            continue
+        for line in open(os.path.join(user, name), encoding="utf-8"):
+            if "printf(" in line and "sprintf(" not in line:
+                continue
+            if line.lstrip().startswith(("#", "//", "*")) or "__attribute__" in line:
+                continue
+            for literal in LITERAL.findall(line):
+                literal = codecs.escape_decode(literal.encode("utf-8"))[0].decode("utf-8", "replace")
+                for conv in CONVERSION.finditer(literal):
+                    kind = conv.group(4)
+                    if kind in "diu":
+                        chars.update("0123456789- ")
+                    elif kind in "xX":
+                        chars.update("0123456789abcdefABCDEF ")
+                    elif kind == "%":
+                        chars.add("%")
+                chars.update(c for c in CONVERSION.sub("", literal) if printable(c, glyphs))
+    if len(chars) > MAX_GLYPHS:
+        raise SystemExit("%d glyphs, at most %d fit uint8_t index" % (len(chars), MAX_GLYPHS))
+    return sorted(chars)
+
+
+def trim(columns):
+    first = 0
+    while first < 8 and columns[first] == 0:
+        first += 1
+    if first == 8:
+        return [0, 0, 0]  # space keeps 3 columns
+    last = 7
+    while columns[last] == 0:
+        last -= 1
+    return columns[first:last + 1]
+
+
+def stretch(columns):
+    top, bottom = [], []
+    for column in columns:
+        wide = 0
+        for bit in range(8):
+            if column & (1 << bit):
+                wide |= 3 << (bit * 2)
+        top += [wide & 0xFF] * 2
+        bottom += [wide >> 8] * 2
+    return top, bottom
+
+
+def hexes(values):
+    return ", ".join("0x%02X" % v for v in values)
+
+
+def main():
+    glyphs = load_font()
+    chars = referenced(glyphs)
+    wide = [c for c in chars if ord(c) >= 0x80]
+
+    out = []
+    out.append("/*")
+    out.append("   Generated by Tools/fontgen.py, DON'T EDIT")
+    out.append("   Source: Tools/font8x8_basic.h, font8x8 by Marcel Sondaar, Tools/font8x8_ext.txt")
+    out.append("   Glyphs: %s" % "".join(chars).replace("*/", "* /"))
+    out.append("*/")
+    out.append("")
+    out.append("#include <stdio.h>")
+    out.append("#include \"fonts.h\"")
+    out.append("")
+
+    index = {c: i for i, c in enumerate(chars)}
+    out.append("const uint8_t fontMap[FONT_MAP_SIZE] = {")
+    row = [index.get(chr(code), MISSING) for code in range(0x20, 0x7F)]
+    for i in range(0, len(row), 16):
+        out.append("  %s," % hexes(row[i:i + 16]))
+    out.append("};")
+    out.append("")
+
+    out.append("const uint8_t fontWideBase = %d;" % (len(chars) - len(wide)))
+    out.append("const uint8_t fontWideCount = %d;" % len(wide))
+    out.append("")
+    out.append("const uint16_t fontWideKeys[%d] = {" % max(len(wide), 1))
+    for i in range(0, len(wide), 12):
+        out.append("  %s," % ", ".join("0x%04X" % ord(c) for c in wide[i:i + 12]))
+    if not wide:
+        out.append("  0")
+    out.append("};")
+    out.append("")
+
+    out.append("const uint8_t font8x8[%d][8] = {" % len(chars))
+    for c in chars:
+        out.append("  { %s },   // U+%04X (%s)" % (hexes(glyphs[ord(c)]), ord(c), c))
+    out.append("};")
+    out.append("")
+
+    offsets, data = [], []
+    for c in chars:
+        offsets.append(len(data))
+        data += trim(glyphs[ord(c)])
+    offsets.append(len(data))
+    out.append("const uint16_t fontPropOffset[%d] = {" % len(offsets))
+    out.append("  %s," % ", ".join(str(o) for o in offsets))
+    out.append("};")
+    out.append("")
+    out.append("const uint8_t fontPropData[%d] = {" % len(data))
+    for i in range(0, len(data), 16):
+        out.append("  %s," % hexes(data[i:i + 16]))
+    out.append("};")
+    out.append("")
+
+    out.append("const char font2xChars[] = \"%s\";" % FONT2X)
+    out.append("")
+    out.append("const uint8_t font2x[%d][2][16] = {" % len(FONT2X))
+    for c in FONT2X:
+        top, bottom = stretch(glyphs[ord(c)])
+        out.append("  { { %s }," % hexes(top))
+        out.append("    { %s } },   // U+%04X (%s)" % (hexes(bottom), ord(c), c))
+    out.append("};")
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+
+    size = 95 + len(wide) * 2 + len(chars) * 8
+    print("%s: %d glyphs, fixed %d bytes, proportional %d bytes, 2x %d bytes" %
+          (os.path.relpath(OUTPUT, ROOT), len(chars), size, len(data) + len(offsets) * 2, len(FONT2X) * 32))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
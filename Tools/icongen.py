@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+Generate User/icons_gen.c from Tools/icons.txt
+
+Icons are 8 rows high (one SSD1306 page), up to 16 columns wide.
+
+Storage per icon, streamed column by column by User/icons.c:
+  - trailing blank columns are dropped (drawn blank by icon()), one leading blank column is a header flag
+  - header byte: bit 7 = raw, bit 6 = mirror, bit 5 = mirror shares center column,
+    bit 4 = leading blank column, bits 0..3 = stored columns - 1
+  - raw: one byte per column, bit 0 = top row
+  - mirror: raw only, left half is stored, right half is read back from it
+  - RLE: pixels column after column, top to bottom, as alternating runs of 0 & 1,
+    one nibble per run (high nibble first), first run is 0; runs over 15 are split with 0 length runs
+  - RLE is used only where it is shorter than raw
+  - no index, icons are packed back to back and found by skipping the ones before
+
+Usage: python3 Tools/icongen.py   (rerun after editing Tools/icons.txt)
+"""
+
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(ROOT, "Tools", "icons.txt")
+OUTPUT = os.path.join(ROOT, "User", "icons_gen.c")
+
+ROWS = 8
+MAX_WIDTH = 16
+
+RAW = 0x80
+MIRROR = 0x40
+CENTER = 0x20
+LEAD = 0x10
+
+
+def load():
+    icons, name, rows = [], None, []
+    for number, line in enumerate(open(SOURCE, encoding="utf-8"), 1):
+        line = line.rstrip()
+        if not line or line.startswith("#"):
+            continue
+        if name is None:
+            name = line
+            continue
+        rows.append(line)
+        if len(rows) == ROWS:
+            width = len(rows[0])
+            if any(len(r) != width for r in rows) or not 1 <= width <= MAX_WIDTH:
+                raise SystemExit("%s:%d: icon '%s' rows must have same width 1..%d" % (SOURCE, number, name, MAX_WIDTH))
+            columns = [sum(1 << y for y in range(ROWS) if rows[y][x] == "X") for x in range(width)]
+            icons.append((name, columns))
+            name, rows = None, []
+    if name is not None:
+        raise SystemExit("%s: icon '%s' has less than %d rows" % (SOURCE, name, ROWS))
+    return icons
+
+
+def rle(columns):
+    bits = [(c >> y) & 1 for c in columns for y in range(ROWS)]
+    runs, color, i = [], 0, 0
+    while i < len(bits):
+        n = 0
+        while i < len(bits) and bits[i] == color:
+            n += 1
+            i += 1
+        while n > 15:
+            runs += [15, 0]
+            n -= 15
+        runs.append(n)
+        color ^= 1
+    if len(runs) % 2:
+        runs.append(0)
+    return [(runs[i] << 4) | runs[i + 1] for i in range(0, len(runs), 2)]
+
+
+def pack(columns):
+    """Header byte and stored bytes of one icon, smallest form that decodes back to columns"""
+    columns = list(columns)
+    while columns and columns[-1] == 0:
+        columns.pop()
+    header = 0
+    if len(columns) > 1 and columns[0] == 0:
+        header |= LEAD
+        columns.pop(0)
+    if not columns:
+        return RAW, [0]
+    if columns == columns[::-1] and len(columns) > 1:
+        half = columns[:(len(columns) + 1) // 2]
+        header |= RAW | MIRROR | (CENTER if len(columns) % 2 else 0) | (len(half) - 1)
+        return header, half
+    packed = rle(columns)
+    if len(packed) < len(columns):
+        return header | (len(columns) - 1), packed
+    return header | RAW | (len(columns) - 1), columns
+
+
+def hexes(values):
+    return ", ".join("0x%02X" % v for v in values)
+
+
+def main():
+    icons = load()
+    out = []
+    data, raw_total, lines = [], 0, []
+    for name, columns in icons:
+        header, stored = pack(columns)
+        raw_total += len(columns)
+        kind = "mirror" if header & MIRROR else "raw" if header & RAW else "rle"
+        lines.append("  %s,   // %s, %s" % (hexes([header] + stored), name, kind))
+        data += [header] + stored
+
+    out.append("/*")
+    out.append("   Generated by Tools/icongen.py, DON'T EDIT")
+    out.append("   Source: Tools/icons.txt, %d icons, %d bytes raw, %d bytes packed" % (len(icons), raw_total, len(data)))
+    out.append("*/")
+    out.append("")
+    out.append("#include <stdio.h>")
+    out.append("#include \"icons.h\"")
+    out.append("")
+    out.append("const uint8_t iconCount = %d;" % len(icons))
+    out.append("")
+    out.append("const uint8_t iconData[%d] = {" % len(data))
+    out += lines
+    out.append("};")
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+
+    print("%s: %d icons, %d bytes raw, %d bytes packed" %
+          (os.path.relpath(OUTPUT, ROOT), len(icons), raw_total, len(data)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+Generate User/titles_gen.c from Tools/titles.txt
+
+Manifest, one title per line, '#' starts a comment:
+  FF/TTT Title text
+  02/001 My favorite song          -> SD_ROOT/02/001*.mp3
+
+Storage:
+  - canonical Huffman code over title bytes (UTF-8 kept as bytes), 0x00 ends title
+  - every title starts on a byte boundary, index is sorted (folder << 8 | track) keys
+  - decoder in User/titles.c walks bits straight from flash, no RAM buffer
+
+Usage: python3 Tools/titlegen.py   (rerun after editing the manifest, then Tools/fontgen.py)
+"""
+
+import heapq
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+MANIFEST = os.path.join(ROOT, "Tools", "titles.txt")
+OUTPUT = os.path.join(ROOT, "User", "titles_gen.c")
+
+MAX_BITS = 15  # must match TITLE_MAX_BITS in User/titles.h
+END = 0
+
+
+def load():
+    titles = {}
+    for number, line in enumerate(open(MANIFEST, encoding="utf-8"), 1):
+        line = line.split("#", 1)[0].strip()
+        if not line:
+            continue
+        m = re.match(r"(\d{1,2})/(\d{1,3})\s+(.+)$", line)
+        if not m:
+            raise SystemExit("%s:%d: expected 'FF/TTT Title'" % (MANIFEST, number))
+        folder, track = int(m.group(1)), int(m.group(2))
+        if not (1 <= folder <= 99 and 1 <= track <= 255):
+            raise SystemExit("%s:%d: folder 1..99, track 1..255" % (MANIFEST, number))
+        titles[(folder << 8) | track] = m.group(3).encode("utf-8")
+    return dict(sorted(titles.items()))
+
+
+def code_lengths(freq):
+    if len(freq) == 1:
+        return {next(iter(freq)): 1}
+    heap = [(f, i, [s]) for i, (s, f) in enumerate(sorted(freq.items()))]
+    heapq.heapify(heap)
+    lengths = dict.fromkeys(freq, 0)
+    order = len(heap)
+    while len(heap) > 1:
+        f1, _, s1 = heapq.heappop(heap)
+        f2, _, s2 = heapq.heappop(heap)
+        for s in s1 + s2:
+            lengths[s] += 1
+        heapq.heappush(heap, (f1 + f2, order, s1 + s2))
+        order += 1
+    if max(lengths.values()) > MAX_BITS:
+        raise SystemExit("code longer than %d bits, too many rare symbols" % MAX_BITS)
+    return lengths
+
+
+def canonical(lengths):
+    symbols = sorted(lengths, key=lambda s: (lengths[s], s))
+    codes, code, previous = {}, 0, 0
+    for s in symbols:
+        code <<= lengths[s] - previous
+        previous = lengths[s]
+        codes[s] = (code, lengths[s])
+        code += 1
+    counts = [sum(1 for s in symbols if lengths[s] == n) for n in range(1, MAX_BITS + 1)]
+    return codes, counts, symbols
+
+
+def encode(text, codes):
+    bits = []
+    for s in list(text) + [END]:
+        code, length = codes[s]
+        bits += [(code >> (length - 1 - i)) & 1 for i in range(length)]
+    bits += [0] * (-len(bits) % 8)
+    return [int("".join(map(str, bits[i:i + 8])), 2) for i in range(0, len(bits), 8)]
+
+
+def hexes(values):
+    return ", ".join("0x%02X" % v for v in values)
+
+
+def main():
+    titles = load()
+    freq = {END: len(titles) or 1}
+    for text in titles.values():
+        for b in text:
+            freq[b] = freq.get(b, 0) + 1
+    codes, counts, symbols = canonical(code_lengths(freq))
+
+    data, offsets = [], []
+    for text in titles.values():
+        offsets.append(len(data))
+        data += encode(text, codes)
+    if len(data) > 0xFFFF:
+        raise SystemExit("title data over 64 KB")
+
+    raw = sum(len(t) + 1 for t in titles.values())
+    out = []
+    out.append("/*")
+    out.append("   Generated by Tools/titlegen.py, DON'T EDIT")
+    out.append("   Source: Tools/titles.txt, %d titles, %d bytes raw, %d bytes coded" % (len(titles), raw, len(data)))
+    out.append("*/")
+    out.append("")
+    out.append("#include <stdio.h>")
+    out.append("#include \"titles.h\"")
+    out.append("")
+    out.append("const uint16_t titleCount = %d;" % len(titles))
+    out.append("")
+    out.append("const uint8_t titleLengths[TITLE_MAX_BITS] = { %s };" % ", ".join(str(c) for c in counts))
+    out.append("")
+    out.append("const uint8_t titleSymbols[%d] = {" % len(symbols))
+    for i in range(0, len(symbols), 16):
+        out.append("  %s," % hexes(symbols[i:i + 16]))
+    out.append("};")
+    out.append("")
+    out.append("const uint16_t titleKeys[%d] = {" % max(len(titles), 1))
+    out.append("  %s," % ", ".join("0x%04X" % k for k in titles) if titles else "  0")
+    out.append("};")
+    out.append("")
+    out.append("const uint16_t titleOffsets[%d] = {" % max(len(offsets), 1))
+    out.append("  %s," % ", ".join(str(o) for o in offsets) if offsets else "  0")
+    out.append("};")
+    out.append("")
+    out.append("const uint8_t titleData[%d] = {" % max(len(data), 1))
+    for i in range(0, len(data), 16):
+        out.append("  %s," % hexes(data[i:i + 16]))
+    out.append("};")
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+
+    table = len(counts) + len(symbols) + len(titles) * 4 + len(data) + 2
+    print("%s: %d titles, %d bytes raw, %d bytes in flash" % (os.path.relpath(OUTPUT, ROOT), len(titles), raw, table))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "debug.h"
+#include "player.h"
+#include "scheduler.h"
+#include "announce.h"
+
+extern uint8_t pFolder;
+extern uint16_t pTrack;
+extern uint8_t pState;
+extern uint8_t pAdvert;
+
+uint16_t aQueue[ANNOUNCE_QUEUE_SIZE];
+uint8_t aHead = 0;
+uint8_t aTail = 0;
+uint8_t aState = ANNOUNCE_IDLE;
+uint16_t aClip = 0;         // clip playing
+uint32_t aSent = 0;         // msec clip was sent
+uint32_t aEnded = 0;        // msec last clip of announcement was done
+uint8_t aFolder = 0;        // main track announcement plays over
+uint16_t aTrack = 0;
+uint16_t aCount = 0;        // announcements with measured resume
+uint16_t aAverage = 0;      // last clip done to main track confirmed playing, msec
+uint16_t aMax = 0;
+uint16_t aTimeouts = 0;     // clips without complete event
+
+/**
+ * @brief Drop clips not played yet
+ */
+void announce_flush() {
+  aHead = aTail;
+}
+
+/**
+ * @brief Send next clip, module holds main track meanwhile
+ */
+void announce_next() {
+  aClip = aQueue[aTail];
+  aTail = (aTail + 1) & (ANNOUNCE_QUEUE_SIZE - 1);
+  aSent = scheduler_millis();
+  aFolder = pFolder;
+  aTrack = pTrack;
+  aState = ANNOUNCE_CLIP;
+  player_playAdvertFolder(aClip);
+}
+
+/**
+ * @brief Queue advert clip
+ * NOTE:
+ *  - module plays adverts only over playing track, nothing is queued otherwise
+ */
+void announce_clip(uint16_t clip) {
+  uint8_t head = (aHead + 1) & (ANNOUNCE_QUEUE_SIZE - 1);
+
+  if (pState != PLAYER_STATE_PLAYING) {
+    return;
+  }
+  if (head == aTail) {
+    printf("Announce: queue full, clip %u dropped\r\n", clip);
+    return;
+  }
+  aQueue[aHead] = clip;
+  aHead = head;
+}
+
+/**
+ * @brief Queue spoken number, hundreds & rest are separate clips
+ */
+void announce_number(uint16_t number) {
+  if (number > ANNOUNCE_NUMBER_MAX) {
+    return;
+  }
+  if (number >= 100) {
+    announce_clip(ANNOUNCE_CLIP_HUNDREDS + (number / 100 - 1) * 100);
+    number %= 100;
+  }
+  if (number > 0) {
+    announce_clip(ANNOUNCE_CLIP_NUMBER + number);
+  }
+}
+
+/**
+ * @brief Queue "folder N track M"
+ */
+void announce_folderTrack(uint8_t folder, uint16_t track) {
+  announce_clip(ANNOUNCE_CLIP_FOLDER);
+  announce_number(folder);
+  announce_clip(ANNOUNCE_CLIP_TRACK);
+  announce_number(track);
+}
+
+/**
+ * @brief Queue low battery warning
+ */
+void announce_lowBattery() {
+  announce_clip(ANNOUNCE_CLIP_BATTERY);
+}
+
+/**
+ * @brief Drop announcement, clip playing is stopped & main track goes on
+ */
+void announce_cancel() {
+  announce_flush();
+  if (aState == ANNOUNCE_CLIP && (pAdvert || player_queued(PLAYER_PLAY_ADVERT_FOLDER))) {
+    player_stopAdvertFolder();
+  }
+  aState = ANNOUNCE_IDLE;
+}
+
+/**
+ * @brief Clip finished, call on PLAYER_EVENT_ADVERT_DONE
+ * NOTE:
+ *  - next clip is sent right away, main track plays only for the link round trip in between
+ *  - clip 0 = module refused advert, main track is not playing, rest is dropped
+ */
+void announce_done(uint16_t clip) {
+  if (aState != ANNOUNCE_CLIP) {
+    return;
+  }
+  if (clip == 0) {
+    printf("Announce: refused, not playing\r\n");
+    announce_flush();
+    aState = ANNOUNCE_IDLE;
+    return;
+  }
+  if (aHead != aTail) {
+    announce_next();
+    return;
+  }
+  // status answer confirms module went back to main track
+  aEnded = scheduler_millis();
+  aState = ANNOUNCE_RESUME;
+  player_query(PLAYER_GET_STATUS, 0);
+}
+
+/**
+ * @brief Start queued announcement & watch it, call from player task
+ * NOTE:
+ *  - clip without complete event is given up after ANNOUNCE_CLIP_TIMEOUT, some modules do not send it
+ *  - resume latency is measured from last clip done to status answer with main track playing
+ *  - track switch drops announcement, module ends advert by itself when other track starts
+ */
+void announce_task() {
+  uint32_t now = scheduler_millis();
+  uint16_t latency;
+
+  if (aState != ANNOUNCE_IDLE && (pFolder != aFolder || pTrack != aTrack)) {
+    printf("Announce: track switched, dropped\r\n");
+    pAdvert = 0;
+    announce_flush();
+    aState = ANNOUNCE_IDLE;
+    return;
+  }
+
+  switch (aState) {
+    case ANNOUNCE_IDLE:
+      if (aHead == aTail) {
+        break;
+      }
+      if (pState != PLAYER_STATE_PLAYING) {
+        announce_flush();
+        break;
+      }
+      announce_next();
+      break;
+
+    case ANNOUNCE_CLIP:
+      if (now - aSent < ANNOUNCE_CLIP_TIMEOUT) {
+        break;
+      }
+      printf("Announce: clip %u not done in time\r\n", aClip);
+      aTimeouts++;
+      pAdvert = 0;
+      announce_done(aClip);
+      break;
+
+    case ANNOUNCE_RESUME:
+      if (player_answered(PLAYER_GET_STATUS)) {
+        latency = now - aEnded;
+        if (pState == PLAYER_STATE_PLAYING) {
+          aAverage = (aCount == 0) ? latency : aAverage + ((int16_t) (latency - aAverage)) / 8;
+          if (latency > aMax) {
+            aMax = latency;
+          }
+          aCount++;
+          printf("Announce: resumed in %u ms\r\n", latency);
+        }
+        aState = ANNOUNCE_IDLE;
+      } else if (now - aEnded > ANNOUNCE_RESUME_TIMEOUT) {
+        printf("Announce: resume not confirmed\r\n");
+        aState = ANNOUNCE_IDLE;
+      }
+      break;
+  }
+}
+
+/**
+ * @brief Print resume latency to debug channel
+ */
+void announce_report() {
+  printf("Announce resume: %u avg %u max %u ms, clip timeouts: %u\r\n", aCount, aAverage, aMax, aTimeouts);
+}
@@ -0,0 +1,44 @@
+#ifndef _ANNOUNCE_H
+#define _ANNOUNCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ANNOUNCE_ENABLE
+#define ANNOUNCE_ENABLE         0     // 1 = long press of NEXT speaks folder & track, needs ENCODER_ENABLE 0
+#endif
+
+#define ANNOUNCE_QUEUE_SIZE     8     // Clips waiting, power of 2
+#define ANNOUNCE_CLIP_TIMEOUT   4000  // Clip without complete event is given up, msec
+#define ANNOUNCE_RESUME_TIMEOUT 1000  // Main track not confirmed playing after last clip, msec
+
+/* Clips in advert folder of card, ADVERT/0001.mp3 .. */
+#define ANNOUNCE_CLIP_NUMBER    0     // 0001..0099 spoken "1".."99"
+#define ANNOUNCE_CLIP_HUNDREDS  100   // 0100..0900 spoken "100".."900"
+#define ANNOUNCE_CLIP_FOLDER    1001  // "folder"
+#define ANNOUNCE_CLIP_TRACK     1002  // "track"
+#define ANNOUNCE_CLIP_BATTERY   1003  // "battery low"
+#define ANNOUNCE_NUMBER_MAX     999
+
+/* Announcement steps */
+enum announce_state {
+  ANNOUNCE_IDLE,
+  ANNOUNCE_CLIP,    // advert clip playing
+  ANNOUNCE_RESUME,  // last clip done, waiting main track is playing again
+};
+
+void announce_clip(uint16_t clip);
+void announce_number(uint16_t number);
+void announce_folderTrack(uint8_t folder, uint16_t track);
+void announce_lowBattery();
+void announce_cancel();
+void announce_done(uint16_t clip);
+void announce_task();
+void announce_report();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
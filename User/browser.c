@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <ch32v00x.h>
+#include "display.h"
+#include "fonts.h"
+#include "titles.h"
+#include "library.h"
+#include "browser.h"
+
+extern uint8_t pFolders;
+
+uint8_t bLevel = BROWSER_FOLDERS;
+uint8_t bFolder = 0;          // folder of track list
+uint8_t bCount = 0;           // items in list, 0 = not known yet
+uint8_t bCursor = 0;          // selected item
+uint8_t bFirst = 0;           // first item on screen once scroll is done
+uint8_t bOrigin = 0;          // item in first page of visible half when list was shown
+uint16_t bLine = 0;           // pixel row of list at top of screen, bFirst * 8 when scroll is done
+int16_t bLow = 0;             // items bLow..bHigh are drawn in GDDRAM ring, empty if bLow > bHigh
+int16_t bHigh = -1;
+uint8_t bMarker = 0;          // item with cursor marker on screen
+uint8_t bKnown[BROWSER_RING]; // folder rows, track count was known when row was drawn
+
+/**
+ * @brief Keep cursor inside list & window around cursor
+ */
+void browser_follow() {
+  if (bCount > 0 && bCursor >= bCount) {
+    bCursor = bCount - 1;
+  }
+  if (bCursor < bFirst) {
+    bFirst = bCursor;
+  } else if (bCursor >= bFirst + BROWSER_ROWS) {
+    bFirst = bCursor - BROWSER_ROWS + 1;
+  }
+}
+
+/**
+ * @brief Force full redraw on next update, call when new display frame was started
+ * NOTE:
+ *  - scroll in progress is finished at once, window is put on visible half again
+ */
+void browser_invalidate() {
+  bOrigin = bFirst;
+  bLine = bFirst * 8;
+  bLow = 0;
+  bHigh = -1;
+  bMarker = bCursor;
+}
+
+/**
+ * @brief Show list from scratch
+ */
+void browser_list(uint8_t level, uint8_t cursor) {
+  bLevel = level;
+  bCount = (level == BROWSER_FOLDERS) ? pFolders : library_tracks(bFolder);
+  if (level == BROWSER_TRACKS) {
+    library_request(bFolder); // list fills in when count arrives
+  }
+  bCursor = cursor;
+  bFirst = 0;
+  browser_follow();
+  browser_invalidate();
+}
+
+/**
+ * @brief Open folder list with cursor on folder
+ * NOTE:
+ *  - caller starts new display frame, see displaySetPage(), same after browser_select() & browser_back()
+ *    as other list is shown
+ */
+void browser_open(uint8_t folder) {
+  bFolder = folder;
+  browser_list(BROWSER_FOLDERS, (folder > 0) ? folder - 1 : 0);
+}
+
+/**
+ * @brief Move cursor, window follows it & scrolls on next browser_update()
+ */
+void browser_move(int16_t steps) {
+  int16_t cursor = bCursor + steps;
+
+  if (bCount == 0) {
+    return;
+  }
+  if (cursor < 0) {
+    cursor = 0;
+  } else if (cursor >= bCount) {
+    cursor = bCount - 1;
+  }
+  bCursor = cursor;
+  browser_follow();
+}
+
+/**
+ * @brief Enter folder under cursor or pick track
+ *
+ * @return 1 = track picked, folder & track set
+ */
+uint8_t browser_select(uint8_t *folder, uint8_t *track) {
+  if (bCount == 0) {
+    return 0;
+  }
+  if (bLevel == BROWSER_FOLDERS) {
+    bFolder = bCursor + 1;
+    browser_list(BROWSER_TRACKS, 0);
+    return 0;
+  }
+  *folder = bFolder;
+  *track = bCursor + 1;
+  return 1;
+}
+
+/**
+ * @brief Go back from track list to folder list
+ *
+ * @return 1 = folder list was shown, close browser
+ */
+uint8_t browser_back() {
+  if (bLevel == BROWSER_TRACKS) {
+    browser_list(BROWSER_FOLDERS, bFolder - 1);
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief Draw row of item into its GDDRAM ring page
+ * NOTE:
+ *  - page may be hidden, it is scrolled in later without redraw
+ */
+void browser_row(int16_t item) {
+  uint8_t line[DISPLAY_WIDTH];
+  char buff[DISPLAY_WIDTH / 8 + 1];
+  struct title_reader reader;
+  uint8_t page = (item - bOrigin) & (BROWSER_RING - 1);
+
+  clear(line, sizeof(line));
+  if (item < bCount && bLevel == BROWSER_FOLDERS) {
+    bKnown[page] = library_known(item + 1);
+    if (bKnown[page]) {
+      sprintf(buff, " Folder %02u %3u", item + 1, library_tracks(item + 1));
+    } else {
+      sprintf(buff, " Folder %02u  --", item + 1);
+    }
+    text(buff, line);
+  } else if (item < bCount) {
+    sprintf(buff, " %03u", item + 1);
+    text(buff, line);
+    if (title_find(bFolder, item + 1, &reader)) {
+      title_render(&reader, 0, line + BROWSER_TEXT_X, DISPLAY_WIDTH - BROWSER_TEXT_X);
+    }
+  } else if (item == 0) {
+    // count not known yet, or nothing there
+    text(library_scanning() ? " ..." : " --", line);
+  }
+  if (item == bCursor) {
+    text(">", line);
+  }
+  display_sendData(page, line, sizeof(line));
+}
+
+/**
+ * @brief Redraw only cursor marker column of row still in ring
+ */
+void browser_marker(int16_t item, uint8_t on) {
+  uint8_t column[8];
+
+  if (item < bLow || item > bHigh) {
+    return;
+  }
+  clear(column, sizeof(column));
+  if (on) {
+    text(">", column);
+  }
+  display_sendColumns((item - bOrigin) & (BROWSER_RING - 1), 0, column, sizeof(column));
+}
+
+/**
+ * @brief Make sure items first..last are drawn in ring, only missing rows are drawn
+ * NOTE:
+ *  - ring keeps BROWSER_RING rows, rows dropped from far end are overwritten later
+ */
+void browser_draw(int16_t first, int16_t last) {
+  if (bLow > bHigh || first > bHigh + 1 || last < bLow - 1) {
+    bLow = first;
+    bHigh = first - 1;
+  }
+  while (bHigh < last) {
+    browser_row(++bHigh);
+    if (bHigh - bLow >= BROWSER_RING) {
+      bLow = bHigh - BROWSER_RING + 1;
+    }
+  }
+  while (bLow > first) {
+    browser_row(--bLow);
+    if (bHigh - bLow >= BROWSER_RING) {
+      bHigh = bLow + BROWSER_RING - 1;
+    }
+  }
+}
+
+/**
+ * @brief Draw browser, call from display task
+ * NOTE:
+ *  - window moves by display start line, only rows scrolled in are drawn, into hidden GDDRAM pages
+ *  - scroll eases out, half of remaining rows per call, BROWSER_STEP_MIN at least
+ *  - moves too far for ring jump at once
+ *  - track counts are asked from library only for folders on screen, track list asks once when shown
+ */
+void browser_update() {
+  uint8_t count = (bLevel == BROWSER_FOLDERS) ? pFolders : library_tracks(bFolder);
+  uint8_t requested = 0;
+  uint8_t moved = 0;
+  int16_t target;
+  int16_t step;
+
+  // counts arrive in background, rows are redrawn in place
+  if (count != bCount) {
+    bCount = count;
+    browser_follow();
+    bLow = 0;
+    bHigh = -1;
+  }
+  target = bFirst * 8;
+  if (abs(target - (int16_t) bLine) > BROWSER_AHEAD * 8) {
+    bLine = target;
+    bLow = 0;
+    bHigh = -1;
+    moved = 1;
+  }
+
+  browser_draw(bFirst, bFirst + BROWSER_ROWS - 1);
+
+  if (bLevel == BROWSER_FOLDERS) {
+    for (int16_t item = bFirst; item < bFirst + BROWSER_ROWS && item < bCount; item++) {
+      if (!library_known(item + 1)) {
+        if (!requested) {
+          library_request(item + 1);
+          requested = 1;
+        }
+      } else if (!bKnown[(item - bOrigin) & (BROWSER_RING - 1)]) {
+        browser_row(item);
+      }
+    }
+  }
+
+  if (bMarker != bCursor) {
+    browser_marker(bMarker, 0);
+    browser_marker(bCursor, 1);
+    bMarker = bCursor;
+  }
+
+  if (bLine != target) {
+    step = abs(target - (int16_t) bLine) / 2;
+    if (step < BROWSER_STEP_MIN) {
+      step = BROWSER_STEP_MIN;
+    }
+    if (step > abs(target - (int16_t) bLine)) {
+      step = abs(target - (int16_t) bLine);
+    }
+    bLine += (target > bLine) ? step : -step;
+    moved = 1;
+  }
+
+  // new list is shown by display_present()
+  if (moved && !display_framePending()) {
+    display_offset(bLine - bOrigin * 8);
+  }
+}
@@ -0,0 +1,35 @@
+#ifndef _BROWSER_H
+#define _BROWSER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef BROWSER_ENABLE
+#define BROWSER_ENABLE    0                                        // 1 = folder & track list page, long press of VOL_UP opens it
+#endif
+
+#define BROWSER_ROWS      DISPLAY_PAGES                            // Rows on screen, one item per page
+#define BROWSER_RING      DISPLAY_RAM_PAGES                        // Rows kept in GDDRAM, hidden ones are drawn ahead of scroll
+#define BROWSER_AHEAD     (BROWSER_RING - BROWSER_ROWS - 1)        // Window moves over more rows are jumps, not scrolled
+#define BROWSER_STEP_MIN  2                                        // Scroll rows per display task at least
+#define BROWSER_TEXT_X    40                                       // Title column of track rows
+
+/* List shown */
+enum browser_level {
+  BROWSER_FOLDERS,  // folders 01..pFolders with track counts
+  BROWSER_TRACKS,   // tracks of bFolder with titles
+};
+
+void browser_open(uint8_t folder);
+void browser_move(int16_t steps);
+uint8_t browser_select(uint8_t *folder, uint8_t *track);
+uint8_t browser_back();
+void browser_update();
+void browser_invalidate();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
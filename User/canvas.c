@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <string.h>
+#include <ch32v00x.h>
+#include "fonts.h"
+#include "icons.h"
+#include "scheduler.h"
+#include "canvas.h"
+
+/**
+ * @brief Clear whole canvas
+ */
+void canvas_clear(struct canvas *canvas) {
+  memset(canvas->buffer, 0, canvas->width * canvas->pages);
+}
+
+/**
+ * @brief Draw bitmap at any pixel position, clipped to canvas
+ * NOTE:
+ *  - bitmap is in SSD1306 layout, pages * width bytes, page after page
+ *  - whole column is assembled into one 32 bit word & shifted once, RV32EC has barrel shifter
+ *    but no byte lanes, so one shift per column beats shifting & carrying every byte
+ *  - clipping is computed once, inner loop has no bounds checks on columns
+ */
+void canvas_blit(struct canvas *canvas, int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t pages, uint8_t mode) {
+  int16_t left = x - canvas->x;
+  int16_t top = y - canvas->y;
+  int16_t first = (left < 0) ? -left : 0;
+  int16_t last = (left + width > canvas->width) ? canvas->width - left : width;
+  int8_t page;
+  uint8_t shift;
+  uint8_t firstPage;
+  uint8_t lastPage;
+
+  if (pages > CANVAS_MAX_PAGES || first >= last || top >= canvas->pages * 8 || top <= -8 * pages) {
+    return;
+  }
+
+  // destination page of word bits 0..7, may be -1..-3 when bitmap starts above canvas
+  page = (top >= 0) ? top / 8 : -((7 - top) / 8);
+  shift = top - page * 8;
+  firstPage = (page < 0) ? -page : 0;
+  lastPage = (page + pages + 1 > canvas->pages) ? canvas->pages - page : pages + 1;
+
+  for (int16_t column = first; column < last; column++) {
+    const uint8_t *source = bitmap + column;
+    uint32_t word = 0;
+    for (uint8_t p = 0; p < pages; p++) {
+      word |= (uint32_t) source[p * width] << (p * 8);
+    }
+    word <<= shift;
+    if (word == 0) {
+      continue;
+    }
+
+    uint8_t *target = canvas->buffer + (page + firstPage) * canvas->width + left + column;
+    word >>= firstPage * 8;
+    for (uint8_t p = firstPage; p < lastPage; p++, word >>= 8, target += canvas->width) {
+      uint8_t bits = word;
+      switch (mode) {
+        case CANVAS_OR:
+          *target |= bits;
+          break;
+        case CANVAS_XOR:
+          *target ^= bits;
+          break;
+        case CANVAS_CLEAR:
+          *target &= ~bits;
+          break;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Draw 8x8 text at any pixel position
+ *
+ * @return x after text
+ */
+int16_t canvas_text(struct canvas *canvas, int16_t x, int16_t y, char *text, uint8_t mode) {
+  uint16_t code;
+
+  while (x < canvas->x + canvas->width && (code = utf8_next(&text)) != 0) {
+    canvas_blit(canvas, x, y, font8x8[glyph(code)], 8, 1, mode);
+    x += 8;
+  }
+  return x;
+}
+
+/**
+ * @brief Draw proportional text at any pixel position
+ *
+ * @return x after text
+ */
+int16_t canvas_textProp(struct canvas *canvas, int16_t x, int16_t y, char *text, uint8_t mode) {
+  uint16_t code;
+
+  while (x < canvas->x + canvas->width && (code = utf8_next(&text)) != 0) {
+    uint8_t b = glyph(code);
+    uint8_t width = fontPropOffset[b + 1] - fontPropOffset[b];
+    canvas_blit(canvas, x, y, &fontPropData[fontPropOffset[b]], width, 1, mode);
+    x += width + FONT_PROP_SPACING;
+  }
+  return x;
+}
+
+/**
+ * @brief Draw icon at any pixel position, decoded column by column straight into canvas
+ * NOTE:
+ *  - ICON_NONE or unknown index draws nothing
+ */
+void canvas_icon(struct canvas *canvas, int16_t x, int16_t y, uint8_t index, uint8_t mode) {
+  struct icon_reader reader;
+  uint8_t width = icon_open(index, &reader);
+
+  for (uint8_t c = 0; c < width; c++) {
+    uint8_t column = icon_column(&reader);
+    canvas_blit(canvas, x + c, y, &column, 1, 1, mode);
+  }
+}
+
+#if (CANVAS_BENCHMARK == 1)
+/**
+ * @brief Print cycles per glyph of text() & blitter, aligned & shifted by 3 rows
+ * NOTE:
+ *  - SysTick counts HCLK, call after scheduler_init()
+ */
+void canvas_benchmark() {
+  uint8_t buffer[2 * 128];
+  struct canvas canvas = { buffer, 128, 2, 0, 0 };
+  char *sample = "0123456789012345"; // glyphs UI has anyway
+  uint32_t start;
+
+  start = scheduler_cycles();
+  text(sample, buffer);
+  printf("Bench text(): %u cycles/glyph\r\n", (scheduler_cycles() - start) / 16);
+
+  start = scheduler_cycles();
+  canvas_text(&canvas, 0, 0, sample, CANVAS_OR);
+  printf("Bench blit y=0: %u cycles/glyph\r\n", (scheduler_cycles() - start) / 16);
+
+  start = scheduler_cycles();
+  canvas_text(&canvas, 0, 3, sample, CANVAS_OR);
+  printf("Bench blit y=3: %u cycles/glyph\r\n", (scheduler_cycles() - start) / 16);
+}
+#endif
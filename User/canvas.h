@@ -0,0 +1,45 @@
+#ifndef _CANVAS_H
+#define _CANVAS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CANVAS_BENCHMARK
+#define CANVAS_BENCHMARK  0  // 1 = print blitter vs text() cycles per glyph at boot
+#endif
+
+#define CANVAS_MAX_PAGES  3  // Bitmap height limit, 3 pages + 7 bit shift fit in 32 bit word
+
+/* Pixel operations */
+enum canvas_mode {
+  CANVAS_OR,    // set bitmap pixels
+  CANVAS_XOR,   // invert under bitmap pixels
+  CANVAS_CLEAR, // clear under bitmap pixels
+};
+
+/*
+ * Region of screen in SSD1306 layout, byte = 8 vertical pixels of column
+ *  - buffer holds pages * width bytes, page after page
+ *  - x/y is screen position of buffer[0] bit 0, drawing outside is clipped
+ */
+struct canvas {
+  uint8_t *buffer;
+  uint8_t width;
+  uint8_t pages;
+  int16_t x;
+  int16_t y;
+};
+
+void canvas_clear(struct canvas *canvas);
+void canvas_blit(struct canvas *canvas, int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t pages, uint8_t mode);
+int16_t canvas_text(struct canvas *canvas, int16_t x, int16_t y, char *text, uint8_t mode);
+void canvas_icon(struct canvas *canvas, int16_t x, int16_t y, uint8_t index, uint8_t mode);
+int16_t canvas_textProp(struct canvas *canvas, int16_t x, int16_t y, char *text, uint8_t mode);
+void canvas_benchmark();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,6 +1,11 @@
 #include <stdio.h>
 #include <ch32v00x.h>
 #include "display.h"
+#include "scheduler.h"
+
+uint8_t dScrolling = 0; // hardware scroll is active
+uint8_t dFront = 0;     // first GDDRAM page of visible half, 0 or DISPLAY_PAGES
+uint8_t dTarget = 0;    // first GDDRAM page written by display_sendColumns(), dFront unless frame is drawn
 
 /**
  * Send data to display
@@ -46,71 +51,33 @@ void display_sendCommand(uint8_t command) {
 
 /**
  * Initialization
+ * NOTE:
+ *  - whole sequence goes in one I2C transfer, SSD1306 takes command bytes until STOP
  */
 void display_init() {
-  // Set MUX Ratio A8h, 3Fh
-  // Set Display Offset D3h, 00h
-  // Set Display Start Line 40h
-  // Set Segment re-map A0h/A1h
-  // Set COM Output Scan Direction C0h/C8h
-  // Set COM Pins hardware configuration DAh, 02
-  // Set Contrast Control 81h, 7Fh
-  // Disable Entire Display On A4h
-  // Set Normal Display A6h
-  // Set Osc Frequency D5h, 80h
-  // Enable charge pump regulator 8Dh, 14h
-  // Display On AFh
-
-  Delay_Ms(100);
-
-  display_sendCommand(SSD1306_DISPLAY_OFF);
-
-	display_sendCommand(SSD1306_SET_DISPLAY_CLOCK_DIV);
-  display_sendCommand(0x00);
-  
-  display_sendCommand(SSD1306_SET_MULTIPLEX);
-  display_sendCommand(SSD1306_MULTIPLEX_128_32);
-
-  display_sendCommand(SSD1306_SET_DISPLAY_OFFSET);
-  display_sendCommand(0x00);
-
-  display_sendCommand(SSD1306_SET_START_LINE | 0x00);
-
-  display_sendCommand(SSD1306_CHARGE_PUMP);
-  display_sendCommand(0x14); // Enable Charge Pump
-
-  display_sendCommand(SSD1306_MEMORY_MODE);
-  display_sendCommand(0x00); // Horizontal addressing mode (A[1:0]=00b)
-  
-  display_sendCommand(SSD1306_SEG_REMAP_YES);
-	
-  display_sendCommand(SSD1306_COM_SCAN_DEC); // Flip?
-
-	display_sendCommand(SSD1306_SET_COM_PINS);
-  display_sendCommand(0x02); //for 128x32 0x02, for 128x64 0x12;
-
-  display_sendCommand(SSD1306_DEACTIVATE_SCROLL);
-
-  display_sendCommand(SSD1306_COLUMN_ADDR);
-  display_sendCommand(0x00);
-  display_sendCommand(0xFF);
-
-  display_sendCommand(SSD1306_PAGE_ADDR);
-  display_sendCommand(0x00);
-  display_sendCommand(0x07);
-
-	display_sendCommand(SSD1306_SET_CONTRAST);
-	display_sendCommand(DISPLAY_DEFAULT_CONTRAST);
-
-	//display_sendCommand(SSD1306_SET_PRE_CHARGE);
-	//display_sendCommand(0xF1);
-
-	display_sendCommand(SSD1306_SET_V_COM_DETECT);
-	display_sendCommand(0x40);
-
-	display_sendCommand(SSD1306_DISPLAY_ALLON_RESUME);
-
-	display_sendCommand(SSD1306_DISPLAY_ON);
+  static const uint8_t sequence[] = {
+    SSD1306_DISPLAY_OFF,
+    SSD1306_SET_DISPLAY_CLOCK_DIV, DISPLAY_CLOCK_DIV,
+    SSD1306_SET_MULTIPLEX, SSD1306_MULTIPLEX_128_32,
+    SSD1306_SET_DISPLAY_OFFSET, 0x00,
+    SSD1306_SET_START_LINE | 0x00,
+    SSD1306_CHARGE_PUMP, 0x14,                // Enable Charge Pump
+    SSD1306_MEMORY_MODE, 0x00,                // Horizontal addressing mode (A[1:0]=00b)
+    SSD1306_SEG_REMAP_YES,
+    SSD1306_COM_SCAN_DEC,                     // Flip?
+    SSD1306_SET_COM_PINS, 0x02,               // for 128x32 0x02, for 128x64 0x12
+    SSD1306_DEACTIVATE_SCROLL,
+    SSD1306_COLUMN_ADDR, 0x00, 0xFF,
+    SSD1306_PAGE_ADDR, 0x00, 0x07,
+    SSD1306_SET_CONTRAST, DISPLAY_DEFAULT_CONTRAST,
+    //SSD1306_SET_PRE_CHARGE, 0xF1,
+    SSD1306_SET_V_COM_DETECT, 0x40,
+    SSD1306_DISPLAY_ALLON_RESUME,
+    SSD1306_DISPLAY_ON,
+  };
+
+  scheduler_delay(100);
+  display_send(0, (uint8_t *) sequence, sizeof(sequence));
 }
 
 /**
@@ -129,17 +96,111 @@ void display_setCursor(uint8_t x, uint8_t y) {
  * @brief Send data to display
  */
 void display_sendData(uint8_t page, uint8_t *data, uint8_t size) {
-	//display_sendCommand(SSD1306_PAGE_ADDR);
-	//display_sendCommand(0x00);
-	//display_sendCommand(0x07);
+	display_sendColumns(page, 0, data, size);
+}
 
-	display_sendCommand(SSD1306_SET_PAGE_START_ADDRESS | page);
-	display_sendCommand(SSD1306_SET_HIGHER_COLUMN_START_ADDRESS);
-	display_sendCommand(SSD1306_SET_LOWER_COLUMN_START_ADDRESS);
+/**
+ * @brief Send data to part of page
+ * NOTE:
+ *  - column & page window is set in one transaction, works in horizontal addressing mode
+ *  - page 0..3 of visible half, or of hidden half while frame is drawn
+ *  - pages 4..7 wrap around GDDRAM, see display_offset()
+ */
+void display_sendColumns(uint8_t page, uint8_t column, uint8_t *data, uint8_t size) {
+	// empty window would wrap to columns column..255
+	if (size == 0) {
+		return;
+	}
+
+	// GDDRAM writes are not allowed while scrolling
+	if (dScrolling) {
+		display_stopScroll();
+	}
+
+	uint8_t window[] = {
+		SSD1306_COLUMN_ADDR, column, column + size - 1,
+		SSD1306_PAGE_ADDR, (dTarget + page) & (DISPLAY_RAM_PAGES - 1), (dTarget + page) & (DISPLAY_RAM_PAGES - 1)
+	};
+	display_send(0, window, sizeof(window));
 
 	display_send(SSD1306_SET_START_LINE, data, size);
 }
 
+/**
+ * @brief Start hardware left scroll of full width pages
+ * NOTE:
+ *  - SSD1306 always scrolls all 128 columns of the pages, content wraps around
+ *  - interval 0..7: 5, 64, 128, 256, 3, 4, 25, 2 frames per step
+ *  - any GDDRAM write stops scrolling, see display_scrolling()
+ */
+void display_scroll(uint8_t startPage, uint8_t endPage, uint8_t interval) {
+	uint8_t scroll[] = {
+		SSD1306_DEACTIVATE_SCROLL,
+		SSD1306_LEFT_HORIZONTAL_SCROLL, 0x00, dTarget + startPage, interval, dTarget + endPage, 0x00, 0xFF,
+		SSD1306_ACTIVATE_SCROLL
+	};
+	display_send(0, scroll, sizeof(scroll));
+	dScrolling = 1;
+}
+
+/**
+ * @brief Stop hardware scroll
+ * NOTE:
+ *  - scrolled pages must be rewritten after stop
+ */
+void display_stopScroll() {
+	display_sendCommand(SSD1306_DEACTIVATE_SCROLL);
+	dScrolling = 0;
+}
+
+/**
+ * @brief Check hardware scroll is still running
+ */
+uint8_t display_scrolling() {
+	return dScrolling;
+}
+
+/**
+ * @brief Start drawing next frame into hidden half of GDDRAM
+ * NOTE:
+ *  - panel shows 32 of 64 GDDRAM rows, start line picks which half is visible
+ *  - window moved by display_offset() shows rows of hidden half, it is put back on visible half first
+ *  - writes are blocking, display task draws rest of frame & presents it at end of its next run
+ *  - frame must redraw all 4 pages, hidden half holds frame before last
+ */
+void display_beginFrame() {
+	display_offset(0);
+	dTarget = dFront ^ DISPLAY_PAGES;
+}
+
+/**
+ * @brief Show drawn frame at once with single start line command
+ * NOTE:
+ *  - writes after present go to visible half again
+ */
+void display_present() {
+	dFront = dTarget;
+	display_sendCommand(SSD1306_SET_START_LINE | (dFront * 8));
+}
+
+/**
+ * @brief Check frame is being drawn & not shown yet
+ */
+uint8_t display_framePending() {
+	return dTarget != dFront;
+}
+
+/**
+ * @brief Move visible window down over GDDRAM without redraw, e.g. smooth list scroll
+ * NOTE:
+ *  - rows below first row of visible half, window wraps around 64 GDDRAM rows
+ *  - rows scrolled in must be drawn before, as pages 4..7 of display_sendColumns()
+ *  - next display_present() puts window back on a half
+ */
+void display_offset(uint8_t rows) {
+	display_sendCommand(SSD1306_SET_START_LINE | ((dFront * 8 + rows) & (DISPLAY_RAM_PAGES * 8 - 1)));
+}
+
 /**
  * @brief Set Contrast, but it look's like does not work
  */
@@ -14,6 +14,16 @@ extern "C" {
 
 #define DISPLAY_DEFAULT_CONTRAST  0x7F
 
+#define DISPLAY_PAGES       4   // Visible pages, 32 rows
+#define DISPLAY_RAM_PAGES   8   // GDDRAM pages, 64 rows, other half is back buffer
+
+/* Frame timing, hardware scroll steps per frame so scroll position follows from it */
+#define DISPLAY_CLOCK_DIV   0x00    // D5h value, oscillator setting << 4 | divide ratio - 1
+#define DISPLAY_PRE_CHARGE  0x22    // D9h reset value, phase 2 << 4 | phase 1, DCLKs
+#define DISPLAY_OSC_HZ      172800  // Oscillator at setting 0, tune if scroll restarts shift text
+#define DISPLAY_FRAME_USEC  (1000000UL * ((DISPLAY_CLOCK_DIV & 0x0F) + 1) \
+  * ((DISPLAY_PRE_CHARGE & 0x0F) + (DISPLAY_PRE_CHARGE >> 4) + 50) * DISPLAY_HEIGHT / DISPLAY_OSC_HZ)
+
 // commands
 #define SSD1306_DISPLAY_OFF                     0xAE
 #define SSD1306_DISPLAY_ON                      0xAF
@@ -66,7 +76,15 @@ void display_init();
 void display_send(uint8_t command, uint8_t *data, uint8_t size);
 void display_setCursor(uint8_t x, uint8_t y);
 void display_sendData(uint8_t page,uint8_t *data, uint8_t size);
+void display_sendColumns(uint8_t page, uint8_t column, uint8_t *data, uint8_t size);
 void display_setContrast(uint8_t value);
+void display_scroll(uint8_t startPage, uint8_t endPage, uint8_t interval);
+void display_stopScroll();
+uint8_t display_scrolling();
+void display_beginFrame();
+void display_present();
+uint8_t display_framePending();
+void display_offset(uint8_t rows);
 
 #ifdef __cplusplus
 }
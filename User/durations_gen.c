@@ -0,0 +1,17 @@
+/*
+   Generated by Tools/durationgen.py, DON'T EDIT
+   Source: none, 0 tracks
+*/
+
+#include <stdio.h>
+#include "position.h"
+
+const uint16_t durationCount = 0;
+
+const uint16_t durationKeys[1] = {
+  0
+};
+
+const uint16_t durationSeconds[1] = {
+  0
+};
@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "encoder.h"
+
+uint16_t eLast = 0; // counter value already turned into steps
+
+/**
+ * @brief Setup TIM2 in encoder mode, edges are counted by hardware without interrupts
+ */
+void encoder_init() {
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOD, ENABLE);
+  RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+  // TIM2 CH1 --> D.4, CH2 --> D.3
+  GPIO_InitTypeDef initEncoder = {0};
+  initEncoder.GPIO_Pin = GPIO_Pin_3 | GPIO_Pin_4;
+  initEncoder.GPIO_Mode = GPIO_Mode_IPU;
+  GPIO_Init(GPIOD, &initEncoder);
+
+  TIM_TimeBaseInitTypeDef initBase = {0};
+  initBase.TIM_Period = 0xFFFF;
+  initBase.TIM_Prescaler = 0;
+  initBase.TIM_ClockDivision = TIM_CKD_DIV4;
+  initBase.TIM_CounterMode = TIM_CounterMode_Up;
+  TIM_TimeBaseInit(TIM2, &initBase);
+
+  TIM_ICInitTypeDef initCapture = {0};
+  initCapture.TIM_ICPolarity = TIM_ICPolarity_Rising;
+  initCapture.TIM_ICSelection = TIM_ICSelection_DirectTI;
+  initCapture.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+  initCapture.TIM_ICFilter = ENCODER_FILTER;
+  initCapture.TIM_Channel = TIM_Channel_1;
+  TIM_ICInit(TIM2, &initCapture);
+  initCapture.TIM_Channel = TIM_Channel_2;
+  TIM_ICInit(TIM2, &initCapture);
+
+  TIM_EncoderInterfaceConfig(TIM2, TIM_EncoderMode_TI12, TIM_ICPolarity_Rising, TIM_ICPolarity_Rising);
+  TIM_SetCounter(TIM2, 0);
+  TIM_Cmd(TIM2, ENABLE);
+
+  eLast = 0;
+}
+
+/**
+ * @brief Detents turned since last call, positive = clockwise
+ * NOTE:
+ *  - partial detents stay in counter for next call
+ *  - 16 bit counter difference is wrap safe while less than 8192 detents per sample
+ */
+int16_t encoder_delta() {
+  int16_t counts = (int16_t) (TIM_GetCounter(TIM2) - eLast);
+  int16_t steps = counts / ENCODER_COUNTS_PER_STEP;
+
+  eLast += steps * ENCODER_COUNTS_PER_STEP;
+  return steps;
+}
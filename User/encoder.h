@@ -0,0 +1,29 @@
+#ifndef _ENCODER_H
+#define _ENCODER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ENCODER_ENABLE
+#define ENCODER_ENABLE          0    // 1 = rotary encoder on TIM2 CH1 (D.4) & CH2 (D.3)
+#endif
+
+#define ENCODER_COUNTS_PER_STEP 4    // Quadrature edges per detent in TI12 mode
+#define ENCODER_FILTER          0x0F // Input capture filter, debounces contacts in hardware
+#define ENCODER_SAMPLE_PERIOD   150  // Counter sample period, msec, one player command per sample at most
+
+/* What the encoder controls */
+enum encoder_mode {
+  ENCODER_MODE_VOLUME,
+  ENCODER_MODE_TRACK,
+};
+
+void encoder_init();
+int16_t encoder_delta();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
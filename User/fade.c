@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "debug.h"
+#include "player.h"
+#include "scheduler.h"
+#include "fade.h"
+
+extern uint16_t pVolume;
+extern uint8_t pState;
+
+uint8_t fState = FADE_IDLE;
+uint8_t fAction = FADE_ACTION_NONE;
+uint8_t fFolder = 0;    // FADE_ACTION_FOLDER target
+uint8_t fTrack = 0;
+uint8_t fLevel = 0;     // module volume, last level sent
+uint8_t fTarget = 0;
+uint16_t fUser = 0;     // pVolume when ramp started, user input changes it
+uint32_t fStart = 0;
+uint32_t fEnd = 0;      // ramp should reach fTarget at this time, msec
+uint8_t fSteps = 0;
+
+/**
+ * @brief Run action waiting for bottom of ramp
+ */
+void fade_run() {
+  uint8_t action = fAction;
+
+  fAction = FADE_ACTION_NONE;
+  switch (action) {
+    case FADE_ACTION_PAUSE:
+      player_pause();
+      break;
+    case FADE_ACTION_STOP:
+      player_stop();
+      break;
+    case FADE_ACTION_NEXT:
+      player_playNext();
+      break;
+    case FADE_ACTION_PREVIOUS:
+      player_playPrevious();
+      break;
+    case FADE_ACTION_FOLDER:
+      player_playFolder(fFolder, fTrack);
+      break;
+  }
+}
+
+/**
+ * @brief Start ramp from current module level
+ * NOTE:
+ *  - action of ramp still running is done at once, request is never lost
+ */
+void fade_start(uint8_t action, uint8_t target, uint16_t time) {
+  if (fAction != FADE_ACTION_NONE) {
+    fade_run();
+  }
+  if (fState == FADE_IDLE) {
+    fLevel = pVolume;
+  }
+  fState = (action != FADE_ACTION_NONE) ? FADE_DOWN : FADE_UP;
+  fAction = action;
+  fTarget = target;
+  fUser = pVolume;
+  fStart = scheduler_millis();
+  fEnd = fStart + time;
+  fSteps = 0;
+}
+
+/**
+ * @brief Fade out, then pause
+ */
+void fade_pause() {
+  if (pState != PLAYER_STATE_PLAYING) {
+    return;
+  }
+  fade_start(FADE_ACTION_PAUSE, 0, FADE_OUT_TIME);
+}
+
+/**
+ * @brief Resume muted, then fade in to user volume
+ */
+void fade_resume() {
+  if (pState == PLAYER_STATE_PLAYING) {
+    return;
+  }
+  fade_start(FADE_ACTION_NONE, pVolume, FADE_IN_TIME);
+  fLevel = 0;
+  player_setLevel(0);
+  player_play();
+}
+
+/**
+ * @brief Pause or resume, fade out still running is turned back up
+ */
+void fade_toggle() {
+  if (fAction == FADE_ACTION_PAUSE) {
+    fAction = FADE_ACTION_NONE;
+    fade_start(FADE_ACTION_NONE, pVolume, FADE_IN_TIME);
+  } else if (pState == PLAYER_STATE_PLAYING) {
+    fade_pause();
+  } else {
+    fade_resume();
+  }
+}
+
+/**
+ * @brief Fade out, then stop
+ */
+void fade_stop() {
+  if (pState != PLAYER_STATE_PLAYING) {
+    player_stop();
+    return;
+  }
+  fade_start(FADE_ACTION_STOP, 0, FADE_OUT_TIME);
+}
+
+/**
+ * @brief Dip volume around switch to next track
+ */
+void fade_next() {
+  if (pState != PLAYER_STATE_PLAYING) {
+    player_playNext();
+    return;
+  }
+  fade_start(FADE_ACTION_NEXT, pVolume >> FADE_DIP_SHIFT, FADE_DIP_TIME);
+}
+
+/**
+ * @brief Dip volume around switch to previous track
+ */
+void fade_previous() {
+  if (pState != PLAYER_STATE_PLAYING) {
+    player_playPrevious();
+    return;
+  }
+  fade_start(FADE_ACTION_PREVIOUS, pVolume >> FADE_DIP_SHIFT, FADE_DIP_TIME);
+}
+
+/**
+ * @brief Dip volume around switch to track in folder
+ * NOTE:
+ *  - dip still going down only gets new target, fast encoder spin sends one command
+ */
+void fade_playFolder(uint8_t folder, uint8_t track) {
+  if (pState != PLAYER_STATE_PLAYING) {
+    player_playFolder(folder, track);
+    return;
+  }
+  if (fState == FADE_DOWN && fAction == FADE_ACTION_FOLDER) {
+    fFolder = folder;
+    fTrack = track;
+    return;
+  }
+  fade_start(FADE_ACTION_FOLDER, pVolume >> FADE_DIP_SHIFT, FADE_DIP_TIME);
+  fFolder = folder;
+  fTrack = track;
+}
+
+/**
+ * @brief Track switch waiting for bottom of dip, next encoder step goes on from it
+ *
+ * @return track, 0 = none
+ */
+uint8_t fade_pendingTrack() {
+  return (fAction == FADE_ACTION_FOLDER) ? fTrack : 0;
+}
+
+/**
+ * @brief Stop ramp, pending action is done at once & module goes back to user volume
+ * NOTE:
+ *  - volume command is merged with pending ramp step, no stale step reaches module
+ */
+void fade_cancel() {
+  if (fState == FADE_IDLE) {
+    return;
+  }
+  fade_run();
+  if (fLevel != pVolume) {
+    player_setLevel(pVolume);
+  }
+  fLevel = pVolume;
+  fState = FADE_IDLE;
+}
+
+/**
+ * @brief Send next ramp step, call from player task
+ * NOTE:
+ *  - next step waits until previous one is answered, fade never adds to link backlog
+ *  - steps are planned FADE_STEP_TIME apart, slow link leaves less time per step, so bigger steps & still ends in time
+ *  - user volume change (pVolume) cancels ramp
+ */
+void fade_task() {
+  uint32_t now = scheduler_millis();
+  uint16_t remaining;
+  uint8_t distance;
+  uint8_t steps;
+
+  if (fState == FADE_IDLE) {
+    return;
+  }
+  if (pVolume != fUser) {
+    printf("Fade: superseded by volume %u\r\n", pVolume);
+    fade_cancel();
+    return;
+  }
+  if (player_queued(PLAYER_SET_VOLUME)) {
+    return;
+  }
+
+  if (fLevel == fTarget) {
+    printf("Fade: %u steps in %u ms\r\n", fSteps, now - fStart);
+    if (fState == FADE_UP) {
+      fState = FADE_IDLE;
+      return;
+    }
+    fade_run();
+    if (pState == PLAYER_STATE_PLAYING) {
+      // track switch, back up to user volume
+      fade_start(FADE_ACTION_NONE, pVolume, FADE_DIP_TIME);
+    } else {
+      // paused or stopped, module is silent, restore level for next start
+      fade_cancel();
+    }
+    return;
+  }
+
+  remaining = ((int32_t) (fEnd - now) > 0) ? fEnd - now : 0;
+  steps = remaining / FADE_STEP_TIME;
+  if (steps == 0) {
+    steps = 1;
+  }
+  distance = (fTarget > fLevel) ? fTarget - fLevel : fLevel - fTarget;
+  distance = (distance + steps - 1) / steps;
+  fLevel = (fTarget > fLevel) ? fLevel + distance : fLevel - distance;
+  player_setLevel(fLevel);
+  fSteps++;
+}
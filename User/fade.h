@@ -0,0 +1,50 @@
+#ifndef _FADE_H
+#define _FADE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef FADE_ENABLE
+#define FADE_ENABLE     0    // 1 = volume ramps around pause, resume & track switch, 0 = commands sent at once
+#endif
+
+#define FADE_IN_TIME    800  // Ramp up on resume, msec
+#define FADE_OUT_TIME   400  // Ramp down before pause & stop, msec
+#define FADE_DIP_TIME   150  // Ramp down & up again around track switch, msec each
+#define FADE_DIP_SHIFT  2    // Track switch dips to volume >> FADE_DIP_SHIFT
+#define FADE_STEP_TIME  50   // Ramp steps are planned this far apart at least, msec
+
+/* Ramp steps */
+enum fade_state {
+  FADE_IDLE,
+  FADE_DOWN,  // action runs at bottom
+  FADE_UP,    // back to user volume pVolume
+};
+
+/* Command run at bottom of ramp */
+enum fade_action {
+  FADE_ACTION_NONE,
+  FADE_ACTION_PAUSE,
+  FADE_ACTION_STOP,
+  FADE_ACTION_NEXT,
+  FADE_ACTION_PREVIOUS,
+  FADE_ACTION_FOLDER,
+};
+
+void fade_pause();
+void fade_resume();
+void fade_toggle();
+void fade_stop();
+void fade_next();
+void fade_previous();
+void fade_playFolder(uint8_t folder, uint8_t track);
+uint8_t fade_pendingTrack();
+void fade_cancel();
+void fade_task();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
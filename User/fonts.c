@@ -1,127 +1,222 @@
 #include <stdio.h>
+#include <string.h>
+#include "fonts.h"
 
-/*
-   Constant: font8x8_basic_tr
-   Contains an 90 digree transposed 8x8 font map for unicode points 
-   U+0000 - U+007F (basic latin)
-   
-   To make it easy to use with SSD1306's GDDRAM mapping and API,
-   this constant is an 90 degree transposed.
-   The original version written by Marcel Sondaar is availble at:
-   https://github.com/dhepper/font8x8/blob/master/font8x8_basic.h 
-*/
-
-const uint8_t font8x8[][8] = {
-  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },   // U+0020 (space)
-  { 0x00, 0x00, 0x06, 0x5F, 0x5F, 0x06, 0x00, 0x00 },   // U+0021 (!)
-  { 0x00, 0x03, 0x03, 0x00, 0x03, 0x03, 0x00, 0x00 },   // U+0022 (")
-  { 0x14, 0x7F, 0x7F, 0x14, 0x7F, 0x7F, 0x14, 0x00 },   // U+0023 (#)
-  { 0x24, 0x2E, 0x6B, 0x6B, 0x3A, 0x12, 0x00, 0x00 },   // U+0024 ($)
-  { 0x46, 0x66, 0x30, 0x18, 0x0C, 0x66, 0x62, 0x00 },   // U+0025 (%)
-  { 0x30, 0x7A, 0x4F, 0x5D, 0x37, 0x7A, 0x48, 0x00 },   // U+0026 (&)
-  { 0x04, 0x07, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 },   // U+0027 (')
-  { 0x00, 0x1C, 0x3E, 0x63, 0x41, 0x00, 0x00, 0x00 },   // U+0028 (()
-  { 0x00, 0x41, 0x63, 0x3E, 0x1C, 0x00, 0x00, 0x00 },   // U+0029 ())
-  { 0x08, 0x2A, 0x3E, 0x1C, 0x1C, 0x3E, 0x2A, 0x08 },   // U+002A (*)
-  { 0x08, 0x08, 0x3E, 0x3E, 0x08, 0x08, 0x00, 0x00 },   // U+002B (+)
-  { 0x00, 0x80, 0xE0, 0x60, 0x00, 0x00, 0x00, 0x00 },   // U+002C (,)
-  { 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00 },   // U+002D (-)
-  { 0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00 },   // U+002E (.)
-  { 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00 },   // U+002F (/)
-  { 0x3E, 0x7F, 0x71, 0x59, 0x4D, 0x7F, 0x3E, 0x00 },   // U+0030 (0)
-  { 0x40, 0x42, 0x7F, 0x7F, 0x40, 0x40, 0x00, 0x00 },   // U+0031 (1)
-  { 0x62, 0x73, 0x59, 0x49, 0x6F, 0x66, 0x00, 0x00 },   // U+0032 (2)
-  { 0x22, 0x63, 0x49, 0x49, 0x7F, 0x36, 0x00, 0x00 },   // U+0033 (3)
-  { 0x18, 0x1C, 0x16, 0x53, 0x7F, 0x7F, 0x50, 0x00 },   // U+0034 (4)
-  { 0x27, 0x67, 0x45, 0x45, 0x7D, 0x39, 0x00, 0x00 },   // U+0035 (5)
-  { 0x3C, 0x7E, 0x4B, 0x49, 0x79, 0x30, 0x00, 0x00 },   // U+0036 (6)
-  { 0x03, 0x03, 0x71, 0x79, 0x0F, 0x07, 0x00, 0x00 },   // U+0037 (7)
-  { 0x36, 0x7F, 0x49, 0x49, 0x7F, 0x36, 0x00, 0x00 },   // U+0038 (8)
-  { 0x06, 0x4F, 0x49, 0x69, 0x3F, 0x1E, 0x00, 0x00 },   // U+0039 (9)
-  { 0x00, 0x00, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00 },   // U+003A (:)
-  { 0x00, 0x80, 0xE6, 0x66, 0x00, 0x00, 0x00, 0x00 },   // U+003B (;)
-  { 0x08, 0x1C, 0x36, 0x63, 0x41, 0x00, 0x00, 0x00 },   // U+003C (<)
-  { 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x00, 0x00 },   // U+003D (=)
-  { 0x00, 0x41, 0x63, 0x36, 0x1C, 0x08, 0x00, 0x00 },   // U+003E (>)
-  { 0x02, 0x03, 0x51, 0x59, 0x0F, 0x06, 0x00, 0x00 },   // U+003F (?)
-  { 0x3E, 0x7F, 0x41, 0x5D, 0x5D, 0x1F, 0x1E, 0x00 },   // U+0040 (@)
-  { 0x7C, 0x7E, 0x13, 0x13, 0x7E, 0x7C, 0x00, 0x00 },   // U+0041 (A)
-  { 0x41, 0x7F, 0x7F, 0x49, 0x49, 0x7F, 0x36, 0x00 },   // U+0042 (B)
-  { 0x1C, 0x3E, 0x63, 0x41, 0x41, 0x63, 0x22, 0x00 },   // U+0043 (C)
-  { 0x41, 0x7F, 0x7F, 0x41, 0x63, 0x3E, 0x1C, 0x00 },   // U+0044 (D)
-  { 0x41, 0x7F, 0x7F, 0x49, 0x5D, 0x41, 0x63, 0x00 },   // U+0045 (E)
-  { 0x41, 0x7F, 0x7F, 0x49, 0x1D, 0x01, 0x03, 0x00 },   // U+0046 (F)
-  { 0x1C, 0x3E, 0x63, 0x41, 0x51, 0x73, 0x72, 0x00 },   // U+0047 (G)
-  { 0x7F, 0x7F, 0x08, 0x08, 0x7F, 0x7F, 0x00, 0x00 },   // U+0048 (H)
-  { 0x00, 0x41, 0x7F, 0x7F, 0x41, 0x00, 0x00, 0x00 },   // U+0049 (I)
-  { 0x30, 0x70, 0x40, 0x41, 0x7F, 0x3F, 0x01, 0x00 },   // U+004A (J)
-  { 0x41, 0x7F, 0x7F, 0x08, 0x1C, 0x77, 0x63, 0x00 },   // U+004B (K)
-  { 0x41, 0x7F, 0x7F, 0x41, 0x40, 0x60, 0x70, 0x00 },   // U+004C (L)
-  { 0x7F, 0x7F, 0x0E, 0x1C, 0x0E, 0x7F, 0x7F, 0x00 },   // U+004D (M)
-  { 0x7F, 0x7F, 0x06, 0x0C, 0x18, 0x7F, 0x7F, 0x00 },   // U+004E (N)
-  { 0x1C, 0x3E, 0x63, 0x41, 0x63, 0x3E, 0x1C, 0x00 },   // U+004F (O)
-  { 0x41, 0x7F, 0x7F, 0x49, 0x09, 0x0F, 0x06, 0x00 },   // U+0050 (P)
-  { 0x1E, 0x3F, 0x21, 0x71, 0x7F, 0x5E, 0x00, 0x00 },   // U+0051 (Q)
-  { 0x41, 0x7F, 0x7F, 0x09, 0x19, 0x7F, 0x66, 0x00 },   // U+0052 (R)
-  { 0x26, 0x6F, 0x4D, 0x59, 0x73, 0x32, 0x00, 0x00 },   // U+0053 (S)
-  { 0x03, 0x41, 0x7F, 0x7F, 0x41, 0x03, 0x00, 0x00 },   // U+0054 (T)
-  { 0x7F, 0x7F, 0x40, 0x40, 0x7F, 0x7F, 0x00, 0x00 },   // U+0055 (U)
-  { 0x1F, 0x3F, 0x60, 0x60, 0x3F, 0x1F, 0x00, 0x00 },   // U+0056 (V)
-  { 0x7F, 0x7F, 0x30, 0x18, 0x30, 0x7F, 0x7F, 0x00 },   // U+0057 (W)
-  { 0x43, 0x67, 0x3C, 0x18, 0x3C, 0x67, 0x43, 0x00 },   // U+0058 (X)
-  { 0x07, 0x4F, 0x78, 0x78, 0x4F, 0x07, 0x00, 0x00 },   // U+0059 (Y)
-  { 0x47, 0x63, 0x71, 0x59, 0x4D, 0x67, 0x73, 0x00 },   // U+005A (Z)
-  { 0x00, 0x7F, 0x7F, 0x41, 0x41, 0x00, 0x00, 0x00 },   // U+005B ([)
-  { 0x01, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x00 },   // U+005C (\)
-  { 0x00, 0x41, 0x41, 0x7F, 0x7F, 0x00, 0x00, 0x00 },   // U+005D (])
-  { 0x08, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x08, 0x00 },   // U+005E (^)
-  { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },   // U+005F (_)
-  { 0x00, 0x00, 0x03, 0x07, 0x04, 0x00, 0x00, 0x00 },   // U+0060 (`)
-  { 0x20, 0x74, 0x54, 0x54, 0x3C, 0x78, 0x40, 0x00 },   // U+0061 (a)
-  { 0x41, 0x7F, 0x3F, 0x48, 0x48, 0x78, 0x30, 0x00 },   // U+0062 (b)
-  { 0x38, 0x7C, 0x44, 0x44, 0x6C, 0x28, 0x00, 0x00 },   // U+0063 (c)
-  { 0x30, 0x78, 0x48, 0x49, 0x3F, 0x7F, 0x40, 0x00 },   // U+0064 (d)
-  { 0x38, 0x7C, 0x54, 0x54, 0x5C, 0x18, 0x00, 0x00 },   // U+0065 (e)
-  { 0x48, 0x7E, 0x7F, 0x49, 0x03, 0x02, 0x00, 0x00 },   // U+0066 (f)
-  { 0x98, 0xBC, 0xA4, 0xA4, 0xF8, 0x7C, 0x04, 0x00 },   // U+0067 (g)
-  { 0x41, 0x7F, 0x7F, 0x08, 0x04, 0x7C, 0x78, 0x00 },   // U+0068 (h)
-  { 0x00, 0x44, 0x7D, 0x7D, 0x40, 0x00, 0x00, 0x00 },   // U+0069 (i)
-  { 0x60, 0xE0, 0x80, 0x80, 0xFD, 0x7D, 0x00, 0x00 },   // U+006A (j)
-  { 0x41, 0x7F, 0x7F, 0x10, 0x38, 0x6C, 0x44, 0x00 },   // U+006B (k)
-  { 0x00, 0x41, 0x7F, 0x7F, 0x40, 0x00, 0x00, 0x00 },   // U+006C (l)
-  { 0x7C, 0x7C, 0x18, 0x38, 0x1C, 0x7C, 0x78, 0x00 },   // U+006D (m)
-  { 0x7C, 0x7C, 0x04, 0x04, 0x7C, 0x78, 0x00, 0x00 },   // U+006E (n)
-  { 0x38, 0x7C, 0x44, 0x44, 0x7C, 0x38, 0x00, 0x00 },   // U+006F (o)
-  { 0x84, 0xFC, 0xF8, 0xA4, 0x24, 0x3C, 0x18, 0x00 },   // U+0070 (p)
-  { 0x18, 0x3C, 0x24, 0xA4, 0xF8, 0xFC, 0x84, 0x00 },   // U+0071 (q)
-  { 0x44, 0x7C, 0x78, 0x4C, 0x04, 0x1C, 0x18, 0x00 },   // U+0072 (r)
-  { 0x48, 0x5C, 0x54, 0x54, 0x74, 0x24, 0x00, 0x00 },   // U+0073 (s)
-  { 0x00, 0x04, 0x3E, 0x7F, 0x44, 0x24, 0x00, 0x00 },   // U+0074 (t)
-  { 0x3C, 0x7C, 0x40, 0x40, 0x3C, 0x7C, 0x40, 0x00 },   // U+0075 (u)
-  { 0x1C, 0x3C, 0x60, 0x60, 0x3C, 0x1C, 0x00, 0x00 },   // U+0076 (v)
-  { 0x3C, 0x7C, 0x70, 0x38, 0x70, 0x7C, 0x3C, 0x00 },   // U+0077 (w)
-  { 0x44, 0x6C, 0x38, 0x10, 0x38, 0x6C, 0x44, 0x00 },   // U+0078 (x)
-  { 0x9C, 0xBC, 0xA0, 0xA0, 0xFC, 0x7C, 0x00, 0x00 },   // U+0079 (y)
-  { 0x4C, 0x64, 0x74, 0x5C, 0x4C, 0x64, 0x00, 0x00 },   // U+007A (z)
-  { 0x08, 0x08, 0x3E, 0x77, 0x41, 0x41, 0x00, 0x00 },   // U+007B ({)
-  { 0x00, 0x00, 0x00, 0x77, 0x77, 0x00, 0x00, 0x00 },   // U+007C (|)
-  { 0x41, 0x41, 0x77, 0x3E, 0x08, 0x08, 0x00, 0x00 },   // U+007D (})
-  { 0x02, 0x03, 0x01, 0x03, 0x02, 0x03, 0x01, 0x00 }    // U+007E (~)
-};
+/**
+ * @brief Feed one byte of UTF-8 text
+ * NOTE:
+ *  - stray continuation bytes, bad lead bytes & code points above U+FFFF give FONT_REPLACEMENT
+ *  - sequence cut by new lead byte is dropped
+ *
+ * @param code set when 1 is returned
+ * @return 1 = code point complete, 0 = more bytes needed
+ */
+uint8_t utf8_feed(struct utf8_decoder *decoder, uint8_t byte, uint16_t *code) {
+  if ((byte & 0xC0) == 0x80) {
+    if (decoder->pending == 0) {
+      *code = FONT_REPLACEMENT;
+      return 1;
+    }
+    decoder->code = (decoder->code << 6) | (byte & 0x3F);
+    if (--decoder->pending > 0) {
+      return 0;
+    }
+    *code = (decoder->code > 0xFFFF) ? FONT_REPLACEMENT : decoder->code;
+    return 1;
+  }
+
+  if (byte < 0x80) {
+    decoder->pending = 0;
+    *code = byte;
+    return 1;
+  } else if (byte >= 0xC0 && byte < 0xE0) {
+    decoder->pending = 1;
+    decoder->code = byte & 0x1F;
+  } else if (byte >= 0xE0 && byte < 0xF0) {
+    decoder->pending = 2;
+    decoder->code = byte & 0x0F;
+  } else if (byte >= 0xF0 && byte < 0xF8) {
+    decoder->pending = 3;
+    decoder->code = byte & 0x07;
+  } else {
+    decoder->pending = 0;
+    *code = FONT_REPLACEMENT;
+    return 1;
+  }
+  return 0;
+}
 
 /**
- * Print some text to display buffer
+ * @brief Decode next code point of UTF-8 string & advance past it
+ * NOTE:
+ *  - sequence cut by end of string gives FONT_REPLACEMENT, next call returns 0
+ *
+ * @return code point, 0 = end of string
+ */
+uint16_t utf8_next(char **text) {
+  struct utf8_decoder decoder = { 0, 0 };
+  uint16_t code;
+
+  while (**text != 0) {
+    uint8_t byte = **text;
+    (*text)++;
+    if (utf8_feed(&decoder, byte, &code)) {
+      return code;
+    }
+  }
+  return decoder.pending ? FONT_REPLACEMENT : 0;
+}
+
+/**
+ * @brief Glyph index of code point in generated subset
+ * NOTE:
+ *  - ASCII is direct lookup, others binary search over fontWideKeys,
+ *    at most 8 steps as glyph index is uint8_t
+ */
+uint8_t glyph(uint16_t code) {
+  uint16_t b = code - 0x20;
+  uint8_t low = 0;
+  uint8_t high = fontWideCount;
+
+  if (code < 0x80) {
+    if (b >= FONT_MAP_SIZE || fontMap[b] == FONT_MISSING) {
+      return fontMap[FONT_REPLACEMENT - 0x20];
+    }
+    return fontMap[b];
+  }
+
+  while (low < high) {
+    uint8_t mid = (low + high) / 2;
+    if (fontWideKeys[mid] < code) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low == fontWideCount || fontWideKeys[low] != code) {
+    return fontMap[FONT_REPLACEMENT - 0x20];
+  }
+  return fontWideBase + low;
+}
+
+/**
+ * Print some text to display buffer, page & column aligned
+ * NOTE:
+ *  - buffer is one 128 column line, text is clipped at FONT_LINE_CHARS
+ *  - text is UTF-8, one glyph per code point
+ *  - see canvas_text() for pixel positions
  * 
  * @param text 
  * @param buffer 
  */
 void text(char *text, uint8_t *buffer) {
-  while (*text > 0) {
-    uint8_t b = *text - 0x20;
+  uint16_t code;
+
+  for (uint8_t n = 0; n < FONT_LINE_CHARS && (code = utf8_next(&text)) != 0; n++) {
+    uint8_t b = glyph(code);
     for (uint8_t p = 0; p < 8; p++) {
       *buffer = font8x8[b][p];
       buffer++;
     }
+  }
+}
+
+/**
+ * Print proportional text to display buffer
+ * 
+ * @param text 
+ * @param buffer 
+ * @param size buffer size, text is clipped
+ * @return used columns
+ */
+uint8_t textProp(char *text, uint8_t *buffer, uint8_t size) {
+  return textPropFrom(text, 0, buffer, size);
+}
+
+/**
+ * Print proportional text to display buffer, first columns skipped
+ * 
+ * @param text 
+ * @param skip columns of rendered text to skip
+ * @param buffer 
+ * @param size buffer size, text is clipped
+ * @return used columns
+ */
+uint8_t textPropFrom(char *text, uint16_t skip, uint8_t *buffer, uint8_t size) {
+  uint8_t x = 0;
+  uint16_t code;
+
+  while (x < size && (code = utf8_next(&text)) != 0) {
+    x += charProp(code, &skip, buffer + x, size - x);
+  }
+  return x;
+}
+
+/**
+ * Print one proportional character, skip is consumed first
+ * 
+ * @param code code point
+ * @param skip columns to skip, decreased by skipped columns
+ * @param buffer 
+ * @param size buffer size
+ * @return used columns
+ */
+uint8_t charProp(uint16_t code, uint16_t *skip, uint8_t *buffer, uint8_t size) {
+  uint8_t b = glyph(code);
+  uint16_t width = fontPropOffset[b + 1] - fontPropOffset[b] + FONT_PROP_SPACING;
+  uint8_t x = 0;
+
+  if (*skip >= width) {
+    *skip -= width;
+    return 0;
+  }
+  for (uint16_t p = fontPropOffset[b] + *skip; p < fontPropOffset[b] + width && x < size; p++) {
+    buffer[x++] = (p < fontPropOffset[b + 1]) ? fontPropData[p] : 0;
+  }
+  *skip = 0;
+  return x;
+}
+
+/**
+ * Width of proportional character in columns
+ */
+uint8_t charPropWidth(uint16_t code) {
+  uint8_t b = glyph(code);
+  return fontPropOffset[b + 1] - fontPropOffset[b] + FONT_PROP_SPACING;
+}
+
+/**
+ * Width of proportional text in columns
+ * 
+ * @param text 
+ * @return columns
+ */
+uint16_t textPropWidth(char *text) {
+  uint16_t width = 0;
+  uint16_t code;
+
+  while ((code = utf8_next(&text)) != 0) {
+    width += charPropWidth(code);
+  }
+  return width;
+}
+
+/**
+ * Print 16x16 text to two page buffers, 16 columns per character
+ * NOTE:
+ *  - only characters from font2xChars, others are blank
+ * 
+ * @param text 
+ * @param top upper page buffer
+ * @param bottom lower page buffer
+ */
+void text2x(char *text, uint8_t *top, uint8_t *bottom) {
+  while (*text > 0) {
+    const char *found = strchr(font2xChars, *text);
+    for (uint8_t p = 0; p < 16; p++) {
+      *top++ = found ? font2x[found - font2xChars][0][p] : 0;
+      *bottom++ = found ? font2x[found - font2xChars][1][p] : 0;
+    }
     text++;
   }
 }
@@ -5,8 +5,40 @@
 extern "C" {
 #endif
 
+#define FONT_MAP_SIZE     95   // ASCII 0x20..0x7E
+#define FONT_MISSING      0xFF // fontMap value for glyph not in build, drawn as '?'
+#define FONT_PROP_SPACING 1    // empty columns between proportional glyphs
+#define FONT_LINE_CHARS   16   // 8x8 characters in 128 column line, text() stops there
+#define FONT_REPLACEMENT  '?'  // drawn for broken UTF-8 & code points without glyph
+
+// Generated tables, see Tools/fontgen.py
+extern const uint8_t fontMap[FONT_MAP_SIZE];
+extern const uint8_t fontWideBase;
+extern const uint8_t fontWideCount;
+extern const uint16_t fontWideKeys[];
+extern const uint8_t font8x8[][8];
+extern const uint16_t fontPropOffset[];
+extern const uint8_t fontPropData[];
+extern const char font2xChars[];
+extern const uint8_t font2x[][2][16];
+
+/* UTF-8 decoder state, for text arriving byte by byte */
+struct utf8_decoder {
+  uint32_t code;
+  uint8_t pending;  // continuation bytes still expected
+};
+
 // Functions
+uint8_t utf8_feed(struct utf8_decoder *decoder, uint8_t byte, uint16_t *code);
+uint16_t utf8_next(char **text);
+uint8_t glyph(uint16_t code);
 void text(char *text, uint8_t *buffer);
+uint8_t textProp(char *text, uint8_t *buffer, uint8_t size);
+uint8_t textPropFrom(char *text, uint16_t skip, uint8_t *buffer, uint8_t size);
+uint16_t textPropWidth(char *text);
+uint8_t charProp(uint16_t code, uint16_t *skip, uint8_t *buffer, uint8_t size);
+uint8_t charPropWidth(uint16_t code);
+void text2x(char *text, uint8_t *top, uint8_t *bottom);
 void clear(uint8_t *buffer, uint8_t size);
 
 #ifdef __cplusplus
@@ -0,0 +1,148 @@
+/*
+   Generated by Tools/fontgen.py, DON'T EDIT
+   Source: Tools/font8x8_basic.h, font8x8 by Marcel Sondaar, Tools/font8x8_ext.txt
+   Glyphs:  %-./0123456789:>?ABCDEFHIMOPRSTUWadefghiklmnorstuvwyéüЗбвдезноё
+*/
+
+#include <stdio.h>
+#include "fonts.h"
+
+const uint8_t fontMap[FONT_MAP_SIZE] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02, 0x03, 0x04,
+  0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0x10, 0x11,
+  0xFF, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0xFF, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0x1A, 0xFF, 0x1B,
+  0x1C, 0xFF, 0x1D, 0x1E, 0x1F, 0x20, 0xFF, 0x21, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x22, 0xFF, 0xFF, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0xFF, 0x29, 0x2A, 0x2B, 0x2C, 0x2D,
+  0xFF, 0xFF, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0x34, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+const uint8_t fontWideBase = 53;
+const uint8_t fontWideCount = 11;
+
+const uint16_t fontWideKeys[11] = {
+  0x00E9, 0x00FC, 0x0417, 0x0431, 0x0432, 0x0434, 0x0435, 0x0437, 0x043D, 0x043E, 0x0451,
+};
+
+const uint8_t font8x8[64][8] = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },   // U+0020 ( )
+  { 0x46, 0x66, 0x30, 0x18, 0x0C, 0x66, 0x62, 0x00 },   // U+0025 (%)
+  { 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00 },   // U+002D (-)
+  { 0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00 },   // U+002E (.)
+  { 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00 },   // U+002F (/)
+  { 0x3E, 0x7F, 0x71, 0x59, 0x4D, 0x7F, 0x3E, 0x00 },   // U+0030 (0)
+  { 0x40, 0x42, 0x7F, 0x7F, 0x40, 0x40, 0x00, 0x00 },   // U+0031 (1)
+  { 0x62, 0x73, 0x59, 0x49, 0x6F, 0x66, 0x00, 0x00 },   // U+0032 (2)
+  { 0x22, 0x63, 0x49, 0x49, 0x7F, 0x36, 0x00, 0x00 },   // U+0033 (3)
+  { 0x18, 0x1C, 0x16, 0x53, 0x7F, 0x7F, 0x50, 0x00 },   // U+0034 (4)
+  { 0x27, 0x67, 0x45, 0x45, 0x7D, 0x39, 0x00, 0x00 },   // U+0035 (5)
+  { 0x3C, 0x7E, 0x4B, 0x49, 0x79, 0x30, 0x00, 0x00 },   // U+0036 (6)
+  { 0x03, 0x03, 0x71, 0x79, 0x0F, 0x07, 0x00, 0x00 },   // U+0037 (7)
+  { 0x36, 0x7F, 0x49, 0x49, 0x7F, 0x36, 0x00, 0x00 },   // U+0038 (8)
+  { 0x06, 0x4F, 0x49, 0x69, 0x3F, 0x1E, 0x00, 0x00 },   // U+0039 (9)
+  { 0x00, 0x00, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00 },   // U+003A (:)
+  { 0x00, 0x41, 0x63, 0x36, 0x1C, 0x08, 0x00, 0x00 },   // U+003E (>)
+  { 0x02, 0x03, 0x51, 0x59, 0x0F, 0x06, 0x00, 0x00 },   // U+003F (?)
+  { 0x7C, 0x7E, 0x13, 0x13, 0x7E, 0x7C, 0x00, 0x00 },   // U+0041 (A)
+  { 0x41, 0x7F, 0x7F, 0x49, 0x49, 0x7F, 0x36, 0x00 },   // U+0042 (B)
+  { 0x1C, 0x3E, 0x63, 0x41, 0x41, 0x63, 0x22, 0x00 },   // U+0043 (C)
+  { 0x41, 0x7F, 0x7F, 0x41, 0x63, 0x3E, 0x1C, 0x00 },   // U+0044 (D)
+  { 0x41, 0x7F, 0x7F, 0x49, 0x5D, 0x41, 0x63, 0x00 },   // U+0045 (E)
+  { 0x41, 0x7F, 0x7F, 0x49, 0x1D, 0x01, 0x03, 0x00 },   // U+0046 (F)
+  { 0x7F, 0x7F, 0x08, 0x08, 0x7F, 0x7F, 0x00, 0x00 },   // U+0048 (H)
+  { 0x00, 0x41, 0x7F, 0x7F, 0x41, 0x00, 0x00, 0x00 },   // U+0049 (I)
+  { 0x7F, 0x7F, 0x0E, 0x1C, 0x0E, 0x7F, 0x7F, 0x00 },   // U+004D (M)
+  { 0x1C, 0x3E, 0x63, 0x41, 0x63, 0x3E, 0x1C, 0x00 },   // U+004F (O)
+  { 0x41, 0x7F, 0x7F, 0x49, 0x09, 0x0F, 0x06, 0x00 },   // U+0050 (P)
+  { 0x41, 0x7F, 0x7F, 0x09, 0x19, 0x7F, 0x66, 0x00 },   // U+0052 (R)
+  { 0x26, 0x6F, 0x4D, 0x59, 0x73, 0x32, 0x00, 0x00 },   // U+0053 (S)
+  { 0x03, 0x41, 0x7F, 0x7F, 0x41, 0x03, 0x00, 0x00 },   // U+0054 (T)
+  { 0x7F, 0x7F, 0x40, 0x40, 0x7F, 0x7F, 0x00, 0x00 },   // U+0055 (U)
+  { 0x7F, 0x7F, 0x30, 0x18, 0x30, 0x7F, 0x7F, 0x00 },   // U+0057 (W)
+  { 0x20, 0x74, 0x54, 0x54, 0x3C, 0x78, 0x40, 0x00 },   // U+0061 (a)
+  { 0x30, 0x78, 0x48, 0x49, 0x3F, 0x7F, 0x40, 0x00 },   // U+0064 (d)
+  { 0x38, 0x7C, 0x54, 0x54, 0x5C, 0x18, 0x00, 0x00 },   // U+0065 (e)
+  { 0x48, 0x7E, 0x7F, 0x49, 0x03, 0x02, 0x00, 0x00 },   // U+0066 (f)
+  { 0x98, 0xBC, 0xA4, 0xA4, 0xF8, 0x7C, 0x04, 0x00 },   // U+0067 (g)
+  { 0x41, 0x7F, 0x7F, 0x08, 0x04, 0x7C, 0x78, 0x00 },   // U+0068 (h)
+  { 0x00, 0x44, 0x7D, 0x7D, 0x40, 0x00, 0x00, 0x00 },   // U+0069 (i)
+  { 0x41, 0x7F, 0x7F, 0x10, 0x38, 0x6C, 0x44, 0x00 },   // U+006B (k)
+  { 0x00, 0x41, 0x7F, 0x7F, 0x40, 0x00, 0x00, 0x00 },   // U+006C (l)
+  { 0x7C, 0x7C, 0x18, 0x38, 0x1C, 0x7C, 0x78, 0x00 },   // U+006D (m)
+  { 0x7C, 0x7C, 0x04, 0x04, 0x7C, 0x78, 0x00, 0x00 },   // U+006E (n)
+  { 0x38, 0x7C, 0x44, 0x44, 0x7C, 0x38, 0x00, 0x00 },   // U+006F (o)
+  { 0x44, 0x7C, 0x78, 0x4C, 0x04, 0x1C, 0x18, 0x00 },   // U+0072 (r)
+  { 0x48, 0x5C, 0x54, 0x54, 0x74, 0x24, 0x00, 0x00 },   // U+0073 (s)
+  { 0x00, 0x04, 0x3E, 0x7F, 0x44, 0x24, 0x00, 0x00 },   // U+0074 (t)
+  { 0x3C, 0x7C, 0x40, 0x40, 0x3C, 0x7C, 0x40, 0x00 },   // U+0075 (u)
+  { 0x1C, 0x3C, 0x60, 0x60, 0x3C, 0x1C, 0x00, 0x00 },   // U+0076 (v)
+  { 0x3C, 0x7C, 0x70, 0x38, 0x70, 0x7C, 0x3C, 0x00 },   // U+0077 (w)
+  { 0x9C, 0xBC, 0xA0, 0xA0, 0xFC, 0x7C, 0x00, 0x00 },   // U+0079 (y)
+  { 0x38, 0x7C, 0x56, 0x55, 0x5C, 0x18, 0x00, 0x00 },   // U+00E9 (é)
+  { 0x3C, 0x7C, 0x41, 0x40, 0x3C, 0x7D, 0x40, 0x00 },   // U+00FC (ü)
+  { 0x22, 0x63, 0x49, 0x49, 0x7F, 0x36, 0x00, 0x00 },   // U+0417 (З)
+  { 0x3C, 0x7E, 0x47, 0x45, 0x7D, 0x39, 0x00, 0x00 },   // U+0431 (б)
+  { 0x7C, 0x7C, 0x54, 0x54, 0x7C, 0x28, 0x00, 0x00 },   // U+0432 (в)
+  { 0x70, 0x38, 0x2C, 0x24, 0x3C, 0x3C, 0x60, 0x00 },   // U+0434 (д)
+  { 0x38, 0x7C, 0x54, 0x54, 0x5C, 0x18, 0x00, 0x00 },   // U+0435 (е)
+  { 0x00, 0x44, 0x54, 0x54, 0x7C, 0x28, 0x00, 0x00 },   // U+0437 (з)
+  { 0x7C, 0x7C, 0x10, 0x10, 0x7C, 0x7C, 0x00, 0x00 },   // U+043D (н)
+  { 0x38, 0x7C, 0x44, 0x44, 0x7C, 0x38, 0x00, 0x00 },   // U+043E (о)
+  { 0x38, 0x7D, 0x54, 0x54, 0x5D, 0x18, 0x00, 0x00 },   // U+0451 (ё)
+};
+
+const uint16_t fontPropOffset[65] = {
+  0, 3, 10, 16, 18, 25, 32, 38, 44, 50, 57, 63, 69, 75, 81, 87, 89, 94, 100, 106, 113, 120, 127, 134, 141, 147, 151, 158, 165, 172, 179, 185, 191, 197, 204, 211, 218, 224, 230, 237, 244, 248, 255, 259, 266, 272, 278, 285, 291, 296, 303, 309, 316, 322, 328, 335, 341, 347, 353, 360, 366, 371, 377, 383, 389,
+};
+
+const uint8_t fontPropData[389] = {
+  0x00, 0x00, 0x00, 0x46, 0x66, 0x30, 0x18, 0x0C, 0x66, 0x62, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+  0x60, 0x60, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x3E, 0x7F, 0x71, 0x59, 0x4D, 0x7F, 0x3E,
+  0x40, 0x42, 0x7F, 0x7F, 0x40, 0x40, 0x62, 0x73, 0x59, 0x49, 0x6F, 0x66, 0x22, 0x63, 0x49, 0x49,
+  0x7F, 0x36, 0x18, 0x1C, 0x16, 0x53, 0x7F, 0x7F, 0x50, 0x27, 0x67, 0x45, 0x45, 0x7D, 0x39, 0x3C,
+  0x7E, 0x4B, 0x49, 0x79, 0x30, 0x03, 0x03, 0x71, 0x79, 0x0F, 0x07, 0x36, 0x7F, 0x49, 0x49, 0x7F,
+  0x36, 0x06, 0x4F, 0x49, 0x69, 0x3F, 0x1E, 0x66, 0x66, 0x41, 0x63, 0x36, 0x1C, 0x08, 0x02, 0x03,
+  0x51, 0x59, 0x0F, 0x06, 0x7C, 0x7E, 0x13, 0x13, 0x7E, 0x7C, 0x41, 0x7F, 0x7F, 0x49, 0x49, 0x7F,
+  0x36, 0x1C, 0x3E, 0x63, 0x41, 0x41, 0x63, 0x22, 0x41, 0x7F, 0x7F, 0x41, 0x63, 0x3E, 0x1C, 0x41,
+  0x7F, 0x7F, 0x49, 0x5D, 0x41, 0x63, 0x41, 0x7F, 0x7F, 0x49, 0x1D, 0x01, 0x03, 0x7F, 0x7F, 0x08,
+  0x08, 0x7F, 0x7F, 0x41, 0x7F, 0x7F, 0x41, 0x7F, 0x7F, 0x0E, 0x1C, 0x0E, 0x7F, 0x7F, 0x1C, 0x3E,
+  0x63, 0x41, 0x63, 0x3E, 0x1C, 0x41, 0x7F, 0x7F, 0x49, 0x09, 0x0F, 0x06, 0x41, 0x7F, 0x7F, 0x09,
+  0x19, 0x7F, 0x66, 0x26, 0x6F, 0x4D, 0x59, 0x73, 0x32, 0x03, 0x41, 0x7F, 0x7F, 0x41, 0x03, 0x7F,
+  0x7F, 0x40, 0x40, 0x7F, 0x7F, 0x7F, 0x7F, 0x30, 0x18, 0x30, 0x7F, 0x7F, 0x20, 0x74, 0x54, 0x54,
+  0x3C, 0x78, 0x40, 0x30, 0x78, 0x48, 0x49, 0x3F, 0x7F, 0x40, 0x38, 0x7C, 0x54, 0x54, 0x5C, 0x18,
+  0x48, 0x7E, 0x7F, 0x49, 0x03, 0x02, 0x98, 0xBC, 0xA4, 0xA4, 0xF8, 0x7C, 0x04, 0x41, 0x7F, 0x7F,
+  0x08, 0x04, 0x7C, 0x78, 0x44, 0x7D, 0x7D, 0x40, 0x41, 0x7F, 0x7F, 0x10, 0x38, 0x6C, 0x44, 0x41,
+  0x7F, 0x7F, 0x40, 0x7C, 0x7C, 0x18, 0x38, 0x1C, 0x7C, 0x78, 0x7C, 0x7C, 0x04, 0x04, 0x7C, 0x78,
+  0x38, 0x7C, 0x44, 0x44, 0x7C, 0x38, 0x44, 0x7C, 0x78, 0x4C, 0x04, 0x1C, 0x18, 0x48, 0x5C, 0x54,
+  0x54, 0x74, 0x24, 0x04, 0x3E, 0x7F, 0x44, 0x24, 0x3C, 0x7C, 0x40, 0x40, 0x3C, 0x7C, 0x40, 0x1C,
+  0x3C, 0x60, 0x60, 0x3C, 0x1C, 0x3C, 0x7C, 0x70, 0x38, 0x70, 0x7C, 0x3C, 0x9C, 0xBC, 0xA0, 0xA0,
+  0xFC, 0x7C, 0x38, 0x7C, 0x56, 0x55, 0x5C, 0x18, 0x3C, 0x7C, 0x41, 0x40, 0x3C, 0x7D, 0x40, 0x22,
+  0x63, 0x49, 0x49, 0x7F, 0x36, 0x3C, 0x7E, 0x47, 0x45, 0x7D, 0x39, 0x7C, 0x7C, 0x54, 0x54, 0x7C,
+  0x28, 0x70, 0x38, 0x2C, 0x24, 0x3C, 0x3C, 0x60, 0x38, 0x7C, 0x54, 0x54, 0x5C, 0x18, 0x44, 0x54,
+  0x54, 0x7C, 0x28, 0x7C, 0x7C, 0x10, 0x10, 0x7C, 0x7C, 0x38, 0x7C, 0x44, 0x44, 0x7C, 0x38, 0x38,
+  0x7D, 0x54, 0x54, 0x5D, 0x18,
+};
+
+const char font2xChars[] = "0123456789";
+
+const uint8_t font2x[10][2][16] = {
+  { { 0xFC, 0xFC, 0xFF, 0xFF, 0x03, 0x03, 0xC3, 0xC3, 0xF3, 0xF3, 0xFF, 0xFF, 0xFC, 0xFC, 0x00, 0x00 },
+    { 0x0F, 0x0F, 0x3F, 0x3F, 0x3F, 0x3F, 0x33, 0x33, 0x30, 0x30, 0x3F, 0x3F, 0x0F, 0x0F, 0x00, 0x00 } },   // U+0030 (0)
+  { { 0x00, 0x00, 0x0C, 0x0C, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x30, 0x30, 0x30, 0x30, 0x3F, 0x3F, 0x3F, 0x3F, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00 } },   // U+0031 (1)
+  { { 0x0C, 0x0C, 0x0F, 0x0F, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x3C, 0x3C, 0x00, 0x00, 0x00, 0x00 },
+    { 0x3C, 0x3C, 0x3F, 0x3F, 0x33, 0x33, 0x30, 0x30, 0x3C, 0x3C, 0x3C, 0x3C, 0x00, 0x00, 0x00, 0x00 } },   // U+0032 (2)
+  { { 0x0C, 0x0C, 0x0F, 0x0F, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x3C, 0x3C, 0x00, 0x00, 0x00, 0x00 },
+    { 0x0C, 0x0C, 0x3C, 0x3C, 0x30, 0x30, 0x30, 0x30, 0x3F, 0x3F, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00 } },   // U+0033 (3)
+  { { 0xC0, 0xC0, 0xF0, 0xF0, 0x3C, 0x3C, 0x0F, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00 },
+    { 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x33, 0x33, 0x3F, 0x3F, 0x3F, 0x3F, 0x33, 0x33, 0x00, 0x00 } },   // U+0034 (4)
+  { { 0x3F, 0x3F, 0x3F, 0x3F, 0x33, 0x33, 0x33, 0x33, 0xF3, 0xF3, 0xC3, 0xC3, 0x00, 0x00, 0x00, 0x00 },
+    { 0x0C, 0x0C, 0x3C, 0x3C, 0x30, 0x30, 0x30, 0x30, 0x3F, 0x3F, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00 } },   // U+0035 (5)
+  { { 0xF0, 0xF0, 0xFC, 0xFC, 0xCF, 0xCF, 0xC3, 0xC3, 0xC3, 0xC3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x0F, 0x0F, 0x3F, 0x3F, 0x30, 0x30, 0x30, 0x30, 0x3F, 0x3F, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00 } },   // U+0036 (6)
+  { { 0x0F, 0x0F, 0x0F, 0x0F, 0x03, 0x03, 0xC3, 0xC3, 0xFF, 0xFF, 0x3F, 0x3F, 0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x3F, 0x3F, 0x3F, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },   // U+0037 (7)
+  { { 0x3C, 0x3C, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x3C, 0x3C, 0x00, 0x00, 0x00, 0x00 },
+    { 0x0F, 0x0F, 0x3F, 0x3F, 0x30, 0x30, 0x30, 0x30, 0x3F, 0x3F, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00 } },   // U+0038 (8)
+  { { 0x3C, 0x3C, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xFC, 0xFC, 0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x30, 0x30, 0x30, 0x30, 0x3C, 0x3C, 0x0F, 0x0F, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00 } },   // U+0039 (9)
+};
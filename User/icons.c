@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include "icons.h"
+
+/**
+ * @brief Start decoding icon
+ * NOTE:
+ *  - icons have no index, ones before are skipped by their header, RLE ones by decoding them
+ *
+ * @return width in columns, 0 = no such icon
+ */
+uint8_t icon_open(uint8_t index, struct icon_reader *reader) {
+  if (index >= iconCount) {
+    return 0;
+  }
+
+  reader->data = iconData;
+  for (;;) {
+    uint8_t header = *reader->data++;
+    uint8_t stored = (header & ICON_STORED) + 1;
+
+    reader->header = header;
+    reader->column = 0;
+    reader->width = stored + ((header & ICON_LEAD) ? 1 : 0);
+    if (header & ICON_MIRROR) {
+      reader->width += stored - ((header & ICON_CENTER) ? 1 : 0);
+    }
+    reader->run = 0;
+    reader->color = 1;  // flipped before first run, first run is 0
+    reader->high = 1;
+    if (index-- == 0) {
+      return reader->width;
+    }
+
+    if (header & ICON_RAW) {
+      reader->data += stored;
+    } else {
+      while (reader->column < reader->width) {
+        icon_column(reader);
+      }
+      if (!reader->high) {
+        reader->data++;  // skip padding nibble
+      }
+    }
+  }
+}
+
+/**
+ * @brief Decode next column, bit 0 = top row
+ * NOTE:
+ *  - raw columns are read in place, mirror reads left half backwards
+ *  - RLE runs alternate 0 & 1, one nibble each, 0 length run only flips color
+ */
+uint8_t icon_column(struct icon_reader *reader) {
+  uint8_t column = 0;
+  uint8_t c;
+
+  if (reader->column >= reader->width) {
+    return 0;
+  }
+  c = reader->column++;
+
+  if (reader->header & ICON_LEAD) {
+    if (c == 0) {
+      return 0;
+    }
+    c--;
+  }
+
+  if (reader->header & ICON_RAW) {
+    uint8_t stored = (reader->header & ICON_STORED) + 1;
+
+    if (c >= stored) {
+      c = 2 * stored - ((reader->header & ICON_CENTER) ? 2 : 1) - c;  // mirrored half
+    }
+    return reader->data[c];
+  }
+
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    while (reader->run == 0) {
+      if (reader->high) {
+        reader->run = *reader->data >> 4;
+      } else {
+        reader->run = *reader->data++ & 0x0F;
+      }
+      reader->high ^= 1;
+      reader->color ^= 1;
+    }
+    column |= reader->color << bit;
+    reader->run--;
+  }
+  return column;
+}
+
+/**
+ * @brief Print icon to display buffer, ICON_NONE or unknown index clears 8 columns
+ */
+void icon(uint8_t index, uint8_t *buffer) {
+  struct icon_reader reader;
+  uint8_t width = icon_open(index, &reader);
+
+  for (uint8_t p = 0; p < 8; p++) {
+    buffer[p] = (p < width) ? icon_column(&reader) : 0;
+  }
+}
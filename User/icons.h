@@ -0,0 +1,53 @@
+#ifndef _ICONS_H
+#define _ICONS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ICON_RAW    0x80 // header flag, columns stored as is
+#define ICON_MIRROR 0x40 // header flag, raw left half stored, right half mirrored
+#define ICON_CENTER 0x20 // header flag, mirror shares center column
+#define ICON_LEAD   0x10 // header flag, one blank column before stored ones
+#define ICON_STORED 0x0F // header mask, stored columns - 1
+
+/* Icons, same order as Tools/icons.txt, first three same order as enum player_state */
+enum icon {
+  ICON_STOP,
+  ICON_PLAY,
+  ICON_PAUSE,
+  ICON_REPEAT,
+  ICON_REPEAT_ONE,
+  ICON_SHUFFLE,
+  ICON_SD,
+  ICON_USB,
+  ICON_VOLUME,
+  ICON_ERROR,
+  ICON_FLASH,
+  ICON_NONE = 0xFF, // blank
+};
+
+/* Generated tables, see Tools/icongen.py */
+extern const uint8_t iconCount;
+extern const uint8_t iconData[];
+
+/* Streaming decoder state */
+struct icon_reader {
+  const uint8_t *data;
+  uint8_t header;
+  uint8_t column;   // columns read
+  uint8_t width;    // columns drawn, trailing blank ones not counted
+  uint8_t run;      // pixels left in current run
+  uint8_t color;    // color of current run
+  uint8_t high;     // next nibble is high nibble
+};
+
+uint8_t icon_open(uint8_t index, struct icon_reader *reader);
+uint8_t icon_column(struct icon_reader *reader);
+void icon(uint8_t index, uint8_t *buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
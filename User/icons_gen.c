@@ -0,0 +1,23 @@
+/*
+   Generated by Tools/icongen.py, DON'T EDIT
+   Source: Tools/icons.txt, 11 icons, 88 bytes raw, 63 bytes packed
+*/
+
+#include <stdio.h>
+#include "icons.h"
+
+const uint8_t iconCount = 11;
+
+const uint8_t iconData[63] = {
+  0xD2, 0x7E, 0x7E, 0x7E,   // stop, mirror
+  0x95, 0x7F, 0x3E, 0x3E, 0x1C, 0x1C, 0x08,   // play, raw
+  0xD2, 0x7E, 0x7E, 0x00,   // pause, mirror
+  0x95, 0x3E, 0x62, 0x42, 0x42, 0x46, 0x7C,   // repeat, raw
+  0x95, 0x3E, 0x62, 0x5A, 0x42, 0x46, 0x7C,   // repeat1, raw
+  0x86, 0x22, 0x22, 0x14, 0x08, 0x14, 0x22, 0x62,   // shuffle, raw
+  0x06, 0x26, 0x18, 0x2E, 0x2E, 0x25,   // sd, rle
+  0xD2, 0x18, 0xA2, 0xFF,   // usb, mirror
+  0x84, 0x1C, 0x1C, 0x1C, 0x3E, 0x63,   // volume, raw
+  0xC3, 0xC0, 0xF0, 0xBC, 0xEB,   // error, mirror
+  0xE3, 0x2A, 0x7F, 0x22, 0x6B,   // flash, mirror
+};
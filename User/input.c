@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "input.h"
+
+uint16_t iState = 0;    // debounced pressed buttons
+uint16_t iLast = 0;     // raw pressed buttons on previous poll
+uint8_t iStable = 0;    // polls raw state did not change
+uint8_t iHeld = 0;      // polls debounced state is held
+uint8_t iLongDone = 0;  // long press already reported for current hold
+
+/**
+ * @brief Setup button pins
+ */
+void input_init() {
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC, ENABLE);
+
+  GPIO_InitTypeDef initButtons = {0};
+  initButtons.GPIO_Pin = INPUT_BUTTONS;
+  initButtons.GPIO_Mode = GPIO_Mode_IPU;
+  initButtons.GPIO_Speed = GPIO_Speed_30MHz;
+  GPIO_Init(GPIOC, &initButtons);
+}
+
+/**
+ * @brief Debounce buttons, call every INPUT_POLL_PERIOD msec
+ * NOTE:
+ *  - short press is reported on release, so it never fires together with long press
+ */
+struct input_event input_poll() {
+  struct input_event event = {0};
+  uint16_t raw = ~GPIO_ReadInputData(GPIOC) & INPUT_BUTTONS;
+
+  if (raw != iLast) {
+    iLast = raw;
+    iStable = 0;
+    return event;
+  }
+
+  if (iStable < INPUT_DEBOUNCE) {
+    iStable++;
+    return event;
+  }
+
+  if (raw != iState) {
+    if (raw == 0 && !iLongDone) {
+      event.shortPress = iState;
+    }
+    if (raw == 0) {
+      iLongDone = 0;
+    }
+    iState = raw;
+    iHeld = 0;
+    return event;
+  }
+
+  if (iState != 0 && !iLongDone && ++iHeld >= INPUT_LONG_PRESS) {
+    event.longPress = iState;
+    iLongDone = 1;
+  }
+
+  return event;
+}
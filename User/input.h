@@ -0,0 +1,32 @@
+#ifndef _INPUT_H
+#define _INPUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Buttons on GPIOC, active low with pull-up */
+#define INPUT_BUTTON_PREV       GPIO_Pin_3
+#define INPUT_BUTTON_NEXT       GPIO_Pin_4
+#define INPUT_BUTTON_VOL_DOWN   GPIO_Pin_5
+#define INPUT_BUTTON_VOL_UP     GPIO_Pin_6
+#define INPUT_BUTTONS           (INPUT_BUTTON_PREV | INPUT_BUTTON_NEXT | INPUT_BUTTON_VOL_DOWN | INPUT_BUTTON_VOL_UP)
+
+#define INPUT_POLL_PERIOD       10   // Poll period, msec
+#define INPUT_DEBOUNCE          3    // Stable polls before state change is accepted
+#define INPUT_LONG_PRESS        100  // Polls before press becomes long press (1 sec)
+
+/* Result of one poll */
+struct input_event {
+  uint16_t shortPress; // buttons released before long press time
+  uint16_t longPress;  // buttons held for long press time, reported once
+};
+
+void input_init();
+struct input_event input_poll();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
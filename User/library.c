@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <string.h>
+#include <ch32v00x.h>
+#include "debug.h"
+#include "player.h"
+#include "scheduler.h"
+#include "library.h"
+
+extern uint8_t pFolder;
+extern uint8_t pFolders;
+extern uint16_t pTotalTrack;
+extern uint8_t pQueryFolder;
+extern uint16_t pFolderTracks;
+
+uint8_t lTracks[LIBRARY_FOLDER_MAX]; // track count per folder, valid if bit in lKnown is set
+uint8_t lKnown[(LIBRARY_FOLDER_MAX + 7) / 8];
+uint8_t lFailed[(LIBRARY_FOLDER_MAX + 7) / 8]; // no answer after LIBRARY_RETRY_MAX retries, not scanned again
+uint8_t lState = LIBRARY_IDLE;
+uint8_t lFolder = 0;    // folder queried in LIBRARY_TRACKS
+uint8_t lPending = 0;   // query sent, waiting for answer
+uint8_t lWanted = 0;    // folder asked for by UI, scanned before others
+uint8_t lRetries = 0;   // retries of query pending
+uint8_t lFocus = 0;     // browser is open, only requested & playing folder are scanned
+uint32_t lSent = 0;
+
+/**
+ * @brief Forget cached counts & rescan in background, e.g. after card was inserted
+ * NOTE:
+ *  - pFolders & pTotalTrack are cleared, UI fills them in as answers arrive
+ */
+void library_invalidate() {
+  library_clear();
+  lState = LIBRARY_FOLDERS;
+}
+
+/**
+ * @brief Forget cached counts & stop scan, e.g. after card was removed
+ */
+void library_clear() {
+  memset(lKnown, 0, sizeof(lKnown));
+  memset(lFailed, 0, sizeof(lFailed));
+  lState = LIBRARY_IDLE;
+  lPending = 0;
+  lWanted = 0;
+  lRetries = 0;
+  pFolders = 0;
+  pTotalTrack = 0;
+}
+
+/**
+ * @brief Check track count of folder is cached
+ */
+uint8_t library_known(uint8_t folder) {
+  if (folder < 1 || folder > LIBRARY_FOLDER_MAX) {
+    return 0;
+  }
+  return (lKnown[(folder - 1) >> 3] >> ((folder - 1) & 7)) & 1;
+}
+
+/**
+ * @brief Check track count of folder could not be read, folder is not scanned again until rescan
+ */
+uint8_t library_failed(uint8_t folder) {
+  if (folder < 1 || folder > LIBRARY_FOLDER_MAX) {
+    return 0;
+  }
+  return (lFailed[(folder - 1) >> 3] >> ((folder - 1) & 7)) & 1;
+}
+
+/**
+ * @brief Cached track count of folder, 0 if not known yet
+ */
+uint8_t library_tracks(uint8_t folder) {
+  return library_known(folder) ? lTracks[folder - 1] : 0;
+}
+
+/**
+ * @brief Check background scan is running
+ */
+uint8_t library_scanning() {
+  return lState != LIBRARY_IDLE;
+}
+
+/**
+ * @brief Ask for track count of folder ahead of background scan, e.g. row shown by browser
+ * NOTE:
+ *  - only latest request is kept, UI asks again for rows still shown
+ *  - finished scan is resumed, so count is fetched even if scan was done
+ */
+void library_request(uint8_t folder) {
+  if (folder < 1 || folder > pFolders || library_known(folder) || library_failed(folder)) {
+    return;
+  }
+  lWanted = folder;
+  if (lState == LIBRARY_IDLE) {
+    lState = LIBRARY_TRACKS;
+  }
+}
+
+/**
+ * @brief Hold background scan of folders nobody looks at, e.g. while browser is open
+ * NOTE:
+ *  - requested & playing folder are still fetched, rest of scan goes on after focus ends
+ */
+void library_focus(uint8_t focus) {
+  lFocus = focus;
+}
+
+/**
+ * @brief Copy index cache aside, e.g. before other storage is selected
+ * NOTE:
+ *  - counts of scan still running are kept, scan goes on after library_restore()
+ */
+void library_save(struct library_bank *bank) {
+  bank->folders = (lState == LIBRARY_FOLDERS) ? 0 : pFolders;
+  memcpy(bank->tracks, lTracks, sizeof(lTracks));
+  memcpy(bank->known, lKnown, sizeof(lKnown));
+}
+
+/**
+ * @brief Bring back index cache saved by library_save(), empty bank rescans
+ * NOTE:
+ *  - scan resumes for folders not known yet, ends at once if all were
+ */
+void library_restore(struct library_bank *bank) {
+  if (bank->folders == 0) {
+    library_invalidate();
+    return;
+  }
+  library_clear();
+  pFolders = bank->folders;
+  memcpy(lTracks, bank->tracks, sizeof(lTracks));
+  memcpy(lKnown, bank->known, sizeof(lKnown));
+  lState = LIBRARY_TRACKS;
+}
+
+/**
+ * @brief Check folder still has to be scanned
+ */
+uint8_t library_missing(uint8_t folder) {
+  return folder >= 1 && folder <= pFolders && !library_known(folder) && !library_failed(folder);
+}
+
+/**
+ * @brief Pick next folder to scan, requested folder first, then playing folder
+ *
+ * @return folder, 0 = all folders known or failed
+ */
+uint8_t library_nextFolder() {
+  if (library_missing(lWanted)) {
+    return lWanted;
+  }
+  if (library_missing(pFolder)) {
+    return pFolder;
+  }
+  for (uint8_t folder = 1; folder <= pFolders && folder <= LIBRARY_FOLDER_MAX; folder++) {
+    if (library_missing(folder)) {
+      return folder;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Store track count of folder
+ */
+void library_store(uint8_t folder, uint16_t tracks) {
+  if (folder >= 1 && folder <= LIBRARY_FOLDER_MAX) {
+    lTracks[folder - 1] = (tracks > PLAYER_FOLDER_TRACKS) ? PLAYER_FOLDER_TRACKS : tracks;
+    lKnown[(folder - 1) >> 3] |= 1 << ((folder - 1) & 7);
+  }
+}
+
+/**
+ * @brief Folder count is known, scan folders next
+ */
+void library_folders() {
+  printf("Library: %u folders\r\n", pFolders);
+  lState = LIBRARY_TRACKS;
+}
+
+/**
+ * @brief Query not answered in time, retry it or give up
+ * NOTE:
+ *  - failed folder is skipped, failed folder count ends scan, library_invalidate() starts over
+ */
+void library_timeout() {
+  lPending = 0;
+  if (lRetries < LIBRARY_RETRY_MAX) {
+    lRetries++;
+    return;
+  }
+  lRetries = 0;
+  if (lState == LIBRARY_FOLDERS) {
+    printf("Library: folder count failed\r\n");
+    lState = LIBRARY_IDLE;
+  } else if (lFolder >= 1 && lFolder <= LIBRARY_FOLDER_MAX) {
+    printf("Library: folder %u failed\r\n", lFolder);
+    lFailed[(lFolder - 1) >> 3] |= 1 << ((lFolder - 1) & 7);
+  }
+}
+
+/**
+ * @brief Background scan, one query per LIBRARY_SCAN_PERIOD, call from player task
+ * NOTE:
+ *  - queries are sent only when player queue is empty, user commands are never delayed by scan
+ *  - folder count comes first, then track count of every folder, results are available at once
+ *  - unanswered or refused query is retried LIBRARY_RETRY_MAX times, see library_timeout()
+ *  - pTotalTrack follows cached count of playing folder
+ */
+void library_task() {
+  uint32_t now = scheduler_millis();
+  uint16_t value;
+
+  // folder changed by navigation, total is known without asking module
+  if (library_known(pFolder)) {
+    pTotalTrack = lTracks[pFolder - 1];
+  }
+
+  if (lState == LIBRARY_IDLE) {
+    return;
+  }
+
+  if (lPending) {
+    uint8_t cmd = (lState == LIBRARY_FOLDERS) ? PLAYER_GET_QNT_FOLDERS : PLAYER_GET_QNT_FOLDER_FILES;
+    if (player_answered(cmd)) {
+      lPending = 0;
+      lRetries = 0;
+      if (lState == LIBRARY_FOLDERS) {
+        library_folders();
+      } else {
+        // answer can belong to other query of same kind, e.g. sent by UI
+        library_store(pQueryFolder, pFolderTracks);
+      }
+    } else if (now - lSent >= LIBRARY_QUERY_TIMEOUT) {
+      library_timeout();
+      if (lState == LIBRARY_IDLE) {
+        return;
+      }
+    } else {
+      return;
+    }
+  }
+
+  if (now - lSent < LIBRARY_SCAN_PERIOD || !player_idle()) {
+    return;
+  }
+
+  // cache hit is stored at once, miss queues query
+  if (lState == LIBRARY_FOLDERS) {
+    lPending = !player_get(PLAYER_GET_QNT_FOLDERS, 0, &value);
+    if (!lPending) {
+      pFolders = value;
+      library_folders();
+    }
+  } else {
+    if (lFocus && !library_missing(lWanted) && !library_missing(pFolder)) {
+      return; // user commands get the link, scan resumes when browser is closed
+    }
+    value = library_nextFolder();
+    if (value != lFolder) {
+      lRetries = 0; // retries belong to folder asked before
+    }
+    lFolder = value;
+    if (lFolder == 0) {
+      printf("Library: scan done\r\n");
+      lState = LIBRARY_IDLE;
+      return;
+    }
+    lPending = !player_get(PLAYER_GET_QNT_FOLDER_FILES, lFolder, &value);
+    if (!lPending) {
+      library_store(lFolder, value);
+    }
+  }
+  lSent = now;
+}
@@ -0,0 +1,43 @@
+#ifndef _LIBRARY_H
+#define _LIBRARY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIBRARY_FOLDER_MAX    99   // Folders 01..99 on storage
+#define LIBRARY_SCAN_PERIOD   250  // Pause between background queries, msec, keeps user commands responsive
+#define LIBRARY_QUERY_TIMEOUT 1000 // Unanswered query is retried after it, msec
+#define LIBRARY_RETRY_MAX     2    // Retries of one query, then folder is marked failed & skipped
+
+/* Background scan steps */
+enum library_state {
+  LIBRARY_IDLE,     // cache complete or storage missing
+  LIBRARY_FOLDERS,  // folder count query pending
+  LIBRARY_TRACKS,   // track count of libraryFolder pending
+};
+
+/* Index cache of one storage, kept aside while other storage plays */
+struct library_bank {
+  uint8_t folders;                                // 0 = nothing saved
+  uint8_t tracks[LIBRARY_FOLDER_MAX];
+  uint8_t known[(LIBRARY_FOLDER_MAX + 7) / 8];
+};
+
+void library_invalidate();
+void library_clear();
+void library_task();
+void library_request(uint8_t folder);
+void library_focus(uint8_t focus);
+uint8_t library_known(uint8_t folder);
+uint8_t library_failed(uint8_t folder);
+uint8_t library_tracks(uint8_t folder);
+uint8_t library_scanning();
+void library_save(struct library_bank *bank);
+void library_restore(struct library_bank *bank);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
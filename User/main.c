@@ -2,6 +2,37 @@
 #include "player.h"
 #include "display.h"
 #include "fonts.h"
+#include "input.h"
+#include "scheduler.h"
+#include "widget.h"
+#include "titles.h"
+#include "encoder.h"
+#include "library.h"
+#include "position.h"
+#include "softuart.h"
+#include "variant.h"
+#include "canvas.h"
+#include "icons.h"
+#include "browser.h"
+#include "fade.h"
+#include "announce.h"
+#include "source.h"
+
+#if (SDI_PRINT == SDI_PR_CLOSE)
+#error "USART1 is the player link, set SDI_PRINT to SDI_PR_OPEN, SDI_PR_SOFT or SDI_PR_NONE"
+#endif
+
+#if (VARIANT_ENABLE == 1 && PLAYER_PACE_ENABLE == 0)
+#error "variant is told by measured reply time, set PLAYER_PACE_ENABLE to 1"
+#endif
+
+#if (SOURCE_ENABLE == 1 && BROWSER_ENABLE == 0)
+#error "storage is switched & its index kept by browser, set BROWSER_ENABLE to 1"
+#endif
+
+#if (ANNOUNCE_ENABLE == 1 && ENCODER_ENABLE == 1)
+#error "long press of NEXT switches encoder mode, set ANNOUNCE_ENABLE or ENCODER_ENABLE to 0"
+#endif
 
 /* Global define */
 #define FOLDER_MIN  1
@@ -11,6 +42,27 @@
 #define VOLUME_MIN  0
 #define VOLUME_MAX  30
 
+/* Display pages */
+enum display_page {
+  DISPLAY_PAGE_BOOT,
+  DISPLAY_PAGE_PLAYER,
+  DISPLAY_PAGE_DIAGNOSTICS, // hidden, long press of PREV toggles it
+  DISPLAY_PAGE_BROWSER,     // folder & track list, long press of VOL_UP toggles it
+};
+
+/* Boot sequence steps */
+enum boot_state {
+  BOOT_PROBE,       // status query sent, module answers if it is already up (warm boot)
+  BOOT_RECONCILE,   // warm boot, volume & EQ queried from module
+  BOOT_WAIT_READY,  // module is booting, display comes up meanwhile
+  BOOT_DETECT,      // module variant unknown, checksum style & reply time probed
+  BOOT_WAIT_AUDIO,  // settings & first playback command queued
+  BOOT_DONE,
+};
+
+#define BOOT_PROBE_TIMEOUT  500                     // Status answer timeout, msec
+#define BOOT_READY_TIMEOUT  (2 * PLAYER_BOOT_DELAY) // READY timeout, module is reset after it, msec
+
 /* Global Variable */
 extern uint8_t rxBuffer[PLAYER_UART_FRAME_SIZE];
 extern uint8_t rxPos;
@@ -19,14 +71,78 @@ extern uint8_t pDone;
 extern uint8_t pOk;
 extern uint8_t pSource;
 extern uint16_t pError;
+extern uint8_t pState;
 
 extern uint8_t pFolder;
 extern uint8_t pFolders;
 extern uint16_t pTrack;
 extern uint16_t pVolume;
 extern uint16_t pTotalTrack;
+extern uint8_t pEqualizer;
+extern uint8_t pMode;
+extern uint8_t pErrorRun;
+extern uint16_t pCacheHits;
+extern uint16_t pCacheMisses;
 
-extern const uint8_t font8x8[][8];
+#if (SOURCE_ENABLE == 1)
+extern uint8_t sActive;
+#endif
+
+#if (POSITION_ENABLE == 1)
+extern uint16_t posElapsed;
+extern uint16_t posDuration;
+#endif
+
+#if (SCHEDULER_LOAD_ENABLE == 1)
+extern struct scheduler_load sLoad;
+#endif
+
+enum display_page displayPage = DISPLAY_PAGE_BOOT;
+enum boot_state bootState = BOOT_PROBE;
+uint32_t bootSince = 0;
+uint32_t bootReady = 0;
+uint8_t bootReset = 0;
+
+/* Status icons, derived from player state in displayShow() */
+uint8_t statusSource = ICON_NONE;
+uint8_t statusMode = ICON_NONE;
+uint8_t statusError = ICON_NONE;
+
+/* Boot page */
+struct widget bootWidgets[] = {
+  WIDGET_LABEL_AT(1, 3, "MP3 Player"),
+  WIDGET_LABEL_AT(2, 3, "Booting..."),
+};
+
+/* Player page, 16x4 characters, track number in 16x16 digits over first 2 lines */
+struct widget playerWidgets[] = {
+  WIDGET_NUMBER2X_AT(0, 0, 3, pTrack),
+  WIDGET_LABEL_AT(0, 7, "F"),
+  WIDGET_NUMBER_AT(0, 9, 2, pFolder),
+  WIDGET_LABEL_AT(0, 11, "/"),
+  WIDGET_NUMBER_AT(0, 13, 3, pFolders),
+  WIDGET_LABEL_AT(1, 7, "T"),
+  WIDGET_LABEL_AT(1, 11, "/"),
+  WIDGET_NUMBER_AT(1, 13, 3, pTotalTrack),
+  WIDGET_ICON_AT(3, 0, pState),
+  WIDGET_ICON_AT(3, 1, statusSource),
+  WIDGET_ICON_AT(3, 2, statusMode),
+  WIDGET_ICON_AT(3, 3, statusError),
+#if (POSITION_ENABLE == 1)
+  WIDGET_PROGRESS_AT(3, 36, 40, posElapsed, posDuration),
+#endif
+  WIDGET_VOLUME_AT(3, 80, 48, pVolume, 30),
+};
+
+#if (ENCODER_ENABLE == 1)
+enum encoder_mode encoderMode = ENCODER_MODE_VOLUME;
+uint32_t encoderSampled = 0;
+#endif
+
+/* Title line, full width so it can use hardware scroll */
+struct marquee titleMarquee = MARQUEE_AT(2, 0, 128);
+struct title_reader titleReader;
+uint16_t titleKey = 0;
 
 
 /**
@@ -83,12 +199,6 @@ void initI2C1() {
   initI2C.GPIO_Speed = GPIO_Speed_30MHz;
   GPIO_Init(GPIOC, &initI2C);
 
-  GPIO_InitTypeDef initButtons = {0};
-  initButtons.GPIO_Pin = GPIO_Pin_3 | GPIO_Pin_4 | GPIO_Pin_5 | GPIO_Pin_6;
-  initButtons.GPIO_Mode = GPIO_Mode_IPU;
-  initButtons.GPIO_Speed = GPIO_Speed_30MHz;
-  GPIO_Init(GPIOC, &initButtons);
-
   // I2C
   RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
 
@@ -110,43 +220,609 @@ void initI2C1() {
  */
 void USART1_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 void USART1_IRQHandler(void) {
+  SCHEDULER_ISR_ENTER();
+
   if (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET) {
     rxBuffer[rxPos] = USART_ReceiveData(USART1);
-    if (rxPos == 0 && rxBuffer[rxPos] != PLAYER_UART_START_BYTE) {
-      return;
+    if (rxPos != 0 || rxBuffer[rxPos] == PLAYER_UART_START_BYTE) {
+      rxPos++;
     }
-    rxPos++;
 
     if (rxPos == PLAYER_UART_FRAME_SIZE) {
-      player_return();
+      player_received();
       rxPos = 0;
     }
   }
+
+  SCHEDULER_ISR_EXIT(SCHEDULER_ISR_USART1);
 }
 
 /**
- * @brief Display show information
+ * @brief Display show information, only changed widgets are sent to display
  */
 void displayShow() {
+  uint16_t key = ((uint16_t) pFolder << 8) | pTrack;
+
+  if (key != titleKey) {
+    titleKey = key;
+    if (title_find(pFolder, pTrack, &titleReader)) {
+      marquee_setSource(&titleMarquee, title_render, &titleReader, title_width(&titleReader));
+    } else {
+      marquee_set(&titleMarquee, "");
+    }
+  }
+
+#if (SOURCE_ENABLE == 1)
+  switch (sActive) {
+    case SOURCE_TF:
+      statusSource = ICON_SD;
+      break;
+    case SOURCE_USB:
+      statusSource = ICON_USB;
+      break;
+    case SOURCE_FLASH:
+      statusSource = ICON_FLASH;
+      break;
+    default:
+      statusSource = ICON_NONE;
+      break;
+  }
+#endif
+
+  switch (pMode) {
+    case PLAYER_MODE_ALL:
+    case PLAYER_MODE_FOLDER:
+      statusMode = ICON_REPEAT;
+      break;
+    case PLAYER_MODE_TRACK:
+      statusMode = ICON_REPEAT_ONE;
+      break;
+    case PLAYER_MODE_RANDOM:
+      statusMode = ICON_SHUFFLE;
+      break;
+    default:
+      statusMode = ICON_NONE;
+      break;
+  }
+
+  // error is shown until module answers cleanly again
+  statusError = (pErrorRun > 0) ? ICON_ERROR : ICON_NONE;
+
+  widget_update(playerWidgets, sizeof(playerWidgets) / sizeof(playerWidgets[0]));
+  marquee_update(&titleMarquee);
+}
+
+#if (SCHEDULER_LOAD_ENABLE == 1)
+/**
+ * @brief Display CPU load of last window & query cache hit rate, percent
+ */
+void displayDiagnostics() {
   char buff[17];
   uint8_t line[128];
 
-  sprintf(buff, "Folder: %2d / %3d", pFolder, pFolders);
+  clear(line, sizeof(line));
+  sprintf(buff, "Idle: %3d.%1d%%", scheduler_permille(sLoad.idle) / 10, scheduler_permille(sLoad.idle) % 10);
   text(buff, line);
   display_sendData(0, line, sizeof(line));
 
-  sprintf(buff, "Track: %3d / %3d", pTrack, pTotalTrack);
+  clear(line, sizeof(line));
+  sprintf(buff, "P%3d D%3d I%3d", scheduler_permille(sLoad.task[SCHEDULER_TASK_PLAYER]) / 10,
+    scheduler_permille(sLoad.task[SCHEDULER_TASK_DISPLAY]) / 10, scheduler_permille(sLoad.task[SCHEDULER_TASK_INPUT]) / 10);
   text(buff, line);
   display_sendData(1, line, sizeof(line));
 
-  sprintf(buff, "S: %2d, E: %6d", pSource, pError);
+  clear(line, sizeof(line));
+  sprintf(buff, "U%3d T%3d S%3d", scheduler_permille(sLoad.isr[SCHEDULER_ISR_USART1]) / 10,
+    scheduler_permille(sLoad.isr[SCHEDULER_ISR_TIM]) / 10, scheduler_permille(sLoad.isr[SCHEDULER_ISR_SYSTICK]) / 10);
   text(buff, line);
   display_sendData(2, line, sizeof(line));
 
-  sprintf(buff, "R: %1d, D: %1d, O: %1d", pReady, pDone, pOk);
+  // query cache hit rate since boot
+  uint32_t lookups = (uint32_t) pCacheHits + pCacheMisses;
+  clear(line, sizeof(line));
+  sprintf(buff, "Hits: %3d%%", lookups ? (int) (pCacheHits * 100UL / lookups) : 0);
   text(buff, line);
   display_sendData(3, line, sizeof(line));
 }
+#endif
+
+/**
+ * @brief Display task
+ */
+void displayTask() {
+  switch (displayPage) {
+    case DISPLAY_PAGE_BOOT:
+      widget_update(bootWidgets, sizeof(bootWidgets) / sizeof(bootWidgets[0]));
+      break;
+    case DISPLAY_PAGE_DIAGNOSTICS:
+#if (SCHEDULER_LOAD_ENABLE == 1)
+      displayDiagnostics();
+#endif
+      break;
+    case DISPLAY_PAGE_PLAYER:
+      displayShow();
+      break;
+    case DISPLAY_PAGE_BROWSER:
+#if (BROWSER_ENABLE == 1)
+      browser_update();
+#endif
+      break;
+  }
+
+  if (display_framePending()) {
+    display_present();
+  }
+}
+
+/**
+ * @brief Switch display page, page shown again is fully redrawn
+ * NOTE:
+ *  - new page is drawn into hidden GDDRAM half & shown at once by displayTask(), no tearing
+ */
+void displaySetPage(enum display_page page) {
+  uint8_t line[128];
+
+  display_beginFrame();
+  clear(line, sizeof(line));
+  for (uint8_t p = 0; p < 4; p++) {
+    display_sendData(p, line, sizeof(line));
+  }
+
+  widget_invalidate(bootWidgets, sizeof(bootWidgets) / sizeof(bootWidgets[0]));
+  widget_invalidate(playerWidgets, sizeof(playerWidgets) / sizeof(playerWidgets[0]));
+  titleMarquee.dirty = 1;
+  displayPage = page;
+#if (BROWSER_ENABLE == 1)
+  browser_invalidate();
+  library_focus(page == DISPLAY_PAGE_BROWSER);
+#endif
+}
+
+#if (ENCODER_ENABLE == 1)
+/**
+ * @brief Turn encoder detents into one absolute player command
+ * NOTE:
+ *  - all detents since previous sample are summed, so fast spin sends one command
+ */
+void encoderSample() {
+  int16_t steps = encoder_delta();
+  if (steps == 0) {
+    return;
+  }
+
+#if (BROWSER_ENABLE == 1)
+  if (displayPage == DISPLAY_PAGE_BROWSER) {
+    browser_move(steps);
+    return;
+  }
+#endif
+  if (encoderMode == ENCODER_MODE_VOLUME) {
+    int16_t volume = pVolume + steps;
+    if (volume < VOLUME_MIN) {
+      volume = VOLUME_MIN;
+    } else if (volume > VOLUME_MAX) {
+      volume = VOLUME_MAX;
+    }
+    if (volume != pVolume) {
+      player_setVolume(volume);
+    }
+  } else {
+    int16_t last = (pTotalTrack > 0 && pTotalTrack < 255) ? pTotalTrack : 255;
+#if (FADE_ENABLE == 1)
+    int16_t from = fade_pendingTrack() ? fade_pendingTrack() : pTrack;
+#else
+    int16_t from = pTrack;
+#endif
+    int16_t track = from + steps;
+    if (track < TRACK_MIN) {
+      track = TRACK_MIN;
+    } else if (track > last) {
+      track = last;
+    }
+    if (track != from) {
+#if (FADE_ENABLE == 1)
+      fade_playFolder(pFolder, track);
+#else
+      player_playFolder(pFolder, track);
+#endif
+    }
+  }
+}
+#endif
+
+/**
+ * @brief Start boot sequence, module is probed instead of reset
+ * NOTE:
+ *  - after MCU only reset (brownout, watchdog, flashing) module keeps playing & answers at once
+ *  - after power-up probe gets no answer, READY comes when module has booted
+ */
+void bootStart() {
+  printf("Boot: %s reset\r\n", (RCC_GetFlagStatus(RCC_FLAG_PORRST) == SET) ? "power" : "MCU");
+  RCC_ClearFlag();
+
+#if (VARIANT_ENABLE == 1)
+  variant_load();
+#endif
+  player_query(PLAYER_GET_STATUS, 0);
+  player_task();
+  bootSince = scheduler_millis();
+  bootState = BOOT_PROBE;
+}
+
+/**
+ * @brief Queue settings & playback after module (re)boot
+ * NOTE:
+ *  - warm boot keeps volume & EQ reconciled from module, only playback is sent
+ */
+void bootPlay(uint8_t warm) {
+  bootReady = scheduler_millis();
+
+  if (!warm) {
+    player_setVolume(15);
+  }
+  player_repeatFolder(2);
+  //player_repeatAll(1);
+
+  displaySetPage(DISPLAY_PAGE_PLAYER);
+  bootState = BOOT_WAIT_AUDIO;
+}
+
+/**
+ * @brief Module is up, detect its variant unless known from flash
+ */
+void bootDetect() {
+#if (VARIANT_ENABLE == 1)
+  variant_start();
+  bootState = BOOT_DETECT;
+#else
+  bootPlay(0);
+#endif
+}
+
+/**
+ * @brief Boot sequence, driven by player events instead of fixed delays
+ * NOTE:
+ *  - boot time is counted from scheduler_init(), right after clock setup
+ *  - module is reset only if it neither answers nor reports READY
+ */
+void bootStep() {
+  switch (bootState) {
+    case BOOT_PROBE:
+      if (pReady) {
+        printf("Boot: ready event at %u ms\r\n", scheduler_millis());
+        bootDetect();
+      } else if (player_answered(PLAYER_GET_STATUS)) {
+        printf("Boot: warm, module answered at %u ms\r\n", scheduler_millis());
+#if (VARIANT_ENABLE == 1)
+        variant_start();
+#endif
+        player_query(PLAYER_GET_VOL, 0);
+        player_query(PLAYER_GET_EQ, 0);
+        bootSince = scheduler_millis();
+        bootState = BOOT_RECONCILE;
+      } else if (scheduler_millis() - bootSince >= BOOT_PROBE_TIMEOUT) {
+        bootSince = scheduler_millis();
+        bootState = BOOT_WAIT_READY;
+      }
+      break;
+
+    case BOOT_RECONCILE:
+#if (VARIANT_ENABLE == 1)
+      if (!variant_step()) {
+        return;
+      }
+#endif
+      if (!(player_answered(PLAYER_GET_VOL) && player_answered(PLAYER_GET_EQ))
+          && scheduler_millis() - bootSince < BOOT_PROBE_TIMEOUT) {
+        return;
+      }
+      printf("Boot: source %u, volume %u, EQ %u, state %u\r\n", pSource, pVolume, pEqualizer, pState);
+      // no READY on warm boot, storage is scanned from here
+#if (SOURCE_ENABLE == 1)
+      source_online(pSource);
+#endif
+#if (BROWSER_ENABLE == 1)
+      library_invalidate();
+#endif
+      if (pState == PLAYER_STATE_PLAYING) {
+        // module kept playing through MCU reset
+        printf("Boot: playing at %u ms\r\n", scheduler_millis());
+        displaySetPage(DISPLAY_PAGE_PLAYER);
+        bootState = BOOT_DONE;
+      } else {
+        bootPlay(1);
+      }
+      break;
+
+    case BOOT_WAIT_READY:
+      if (pReady) {
+        printf("Boot: ready event at %u ms\r\n", scheduler_millis());
+        bootDetect();
+      } else if (scheduler_millis() - bootSince >= BOOT_READY_TIMEOUT) {
+        if (bootReset) {
+          printf("Boot: no READY after reset, continue at %u ms\r\n", scheduler_millis());
+          bootPlay(0);
+          return;
+        }
+        // module is silent, this is the only case it is reset
+        printf("Boot: module silent, reset\r\n");
+        player_reset();
+        bootReset = 1;
+        bootSince = scheduler_millis();
+      }
+      break;
+
+    case BOOT_DETECT:
+#if (VARIANT_ENABLE == 1)
+      if (variant_step()) {
+        bootPlay(0);
+      }
+#endif
+      break;
+
+    case BOOT_WAIT_AUDIO:
+      if (!player_idle()) {
+        return;
+      }
+      printf("Boot: first audio at %u ms, %u ms after ready\r\n", scheduler_millis(), scheduler_millis() - bootReady);
+      bootState = BOOT_DONE;
+      break;
+
+    case BOOT_DONE:
+      break;
+  }
+}
+
+/**
+ * @brief Handle module notifications
+ * NOTE:
+ *  - card change rescans folder counts in background, UI shows them as they arrive
+ */
+void playerEvents() {
+  struct player_event event;
+
+  while (player_getEvent(&event)) {
+    switch (event.type) {
+      case PLAYER_EVENT_ONLINE:
+#if (SOURCE_ENABLE == 1)
+        if (source_online(event.value)) {
+          break; // storage switch done, its state is restored
+        }
+#endif
+        if (bootState == BOOT_DONE) {
+          // module rebooted by error recovery or brownout, settings are lost
+          printf("Module online again, restore\r\n");
+#if (FADE_ENABLE == 1)
+          fade_cancel();
+#endif
+          player_setVolume(pVolume);
+          if (pEqualizer) {
+            player_setEqualizer(pEqualizer);
+          }
+          player_playFolder(pFolder, pTrack);
+        }
+        // fall through
+      case PLAYER_EVENT_INSERTED:
+#if (SOURCE_ENABLE == 1)
+        source_inserted(event.value);
+#endif
+        printf("Storage %02x online, rescan\r\n", event.value);
+#if (BROWSER_ENABLE == 1)
+        library_invalidate();
+#endif
+        break;
+
+#if (POSITION_ENABLE == 1)
+      case PLAYER_EVENT_DONE:
+        position_done();
+        break;
+#endif
+
+#if (ANNOUNCE_ENABLE == 1)
+      case PLAYER_EVENT_ADVERT_DONE:
+        announce_done(event.value);
+        break;
+#endif
+
+      case PLAYER_EVENT_REMOVED:
+        printf("Storage %02x removed\r\n", event.value);
+#if (SOURCE_ENABLE == 1)
+        if (source_removed(event.value)) {
+          break; // other storage takes over
+        }
+#endif
+#if (BROWSER_ENABLE == 1)
+        if (pSource == 0) {
+          library_clear();
+        } else {
+          library_invalidate();
+        }
+#endif
+        if (pSource == 0) {
+          pState = PLAYER_STATE_STOPPED;
+        }
+        break;
+    }
+  }
+}
+
+/**
+ * @brief Player task with boot sequence
+ */
+void playerTask() {
+  player_task();
+  bootStep();
+  playerEvents();
+#if (POSITION_ENABLE == 1)
+  position_task();
+#endif
+  if (bootState == BOOT_DONE) {
+#if (BROWSER_ENABLE == 1)
+    // first audio goes before background scan
+    library_task();
+#endif
+#if (VARIANT_ENABLE == 1)
+    variant_task();
+#endif
+#if (FADE_ENABLE == 1)
+    fade_task();
+#endif
+#if (ANNOUNCE_ENABLE == 1)
+    announce_task();
+#endif
+#if (SOURCE_ENABLE == 1)
+    source_task();
+    if (source_changed() && displayPage == DISPLAY_PAGE_BROWSER) {
+      browser_open(pFolder);
+      displaySetPage(DISPLAY_PAGE_BROWSER);
+    }
+#endif
+  }
+}
+
+/**
+ * @brief Map buttons to player commands
+ */
+void playerInput(struct input_event event) {
+#if (SCHEDULER_LOAD_ENABLE == 1)
+  if (event.longPress & INPUT_BUTTON_PREV) {
+    displaySetPage((displayPage == DISPLAY_PAGE_PLAYER) ? DISPLAY_PAGE_DIAGNOSTICS : DISPLAY_PAGE_PLAYER);
+    if (displayPage == DISPLAY_PAGE_DIAGNOSTICS) {
+      player_report();
+#if (ANNOUNCE_ENABLE == 1)
+      announce_report();
+#endif
+#if (SOURCE_ENABLE == 1)
+      source_report();
+#endif
+    }
+  }
+#endif
+#if (BROWSER_ENABLE == 1)
+  if (event.longPress & INPUT_BUTTON_VOL_UP) {
+    browser_open(pFolder);
+    displaySetPage(DISPLAY_PAGE_BROWSER);
+    return;
+  }
+#endif
+
+#if (FADE_ENABLE == 1)
+  if (event.longPress & INPUT_BUTTON_VOL_DOWN) {
+    fade_toggle();
+  }
+
+  if (event.shortPress & INPUT_BUTTON_PREV) {
+    fade_previous();
+  }
+  if (event.shortPress & INPUT_BUTTON_NEXT) {
+    fade_next();
+  }
+#else
+  if (event.longPress & INPUT_BUTTON_VOL_DOWN) {
+    if (pState == PLAYER_STATE_PLAYING) {
+      player_pause();
+    } else {
+      player_play();
+    }
+  }
+
+  if (event.shortPress & INPUT_BUTTON_PREV) {
+    player_playPrevious();
+  }
+  if (event.shortPress & INPUT_BUTTON_NEXT) {
+    player_playNext();
+  }
+#endif
+  if (event.shortPress & INPUT_BUTTON_VOL_DOWN) {
+    player_volumeDown();
+  }
+  if (event.shortPress & INPUT_BUTTON_VOL_UP) {
+    player_volumeUp();
+  }
+
+#if (ENCODER_ENABLE == 1)
+  if (event.longPress & INPUT_BUTTON_NEXT) {
+    encoderMode = (encoderMode == ENCODER_MODE_VOLUME) ? ENCODER_MODE_TRACK : ENCODER_MODE_VOLUME;
+  }
+#elif (ANNOUNCE_ENABLE == 1)
+  if (event.longPress & INPUT_BUTTON_NEXT) {
+    announce_folderTrack(pFolder, pTrack);
+  }
+#endif
+}
+
+#if (BROWSER_ENABLE == 1)
+/**
+ * @brief Map buttons to browser, PREV/NEXT move, VOL_UP enters folder or plays track,
+ *        VOL_DOWN goes back, long press of VOL_UP closes it, long press of PREV switches storage
+ * NOTE:
+ *  - other list is drawn into new frame, moves within list are scrolled by browser_update()
+ */
+void browserInput(struct input_event event) {
+  uint8_t folder;
+  uint8_t track;
+
+#if (SOURCE_ENABLE == 1)
+  if (event.longPress & INPUT_BUTTON_PREV) {
+#if (FADE_ENABLE == 1)
+    fade_cancel();
+#endif
+    source_next();
+  }
+#endif
+  if (event.shortPress & INPUT_BUTTON_PREV) {
+    browser_move(-1);
+  }
+  if (event.shortPress & INPUT_BUTTON_NEXT) {
+    browser_move(1);
+  }
+
+  if (event.longPress & INPUT_BUTTON_VOL_UP) {
+    displaySetPage(DISPLAY_PAGE_PLAYER);
+  } else if (event.shortPress & INPUT_BUTTON_VOL_UP) {
+    if (browser_select(&folder, &track)) {
+#if (FADE_ENABLE == 1)
+      fade_playFolder(folder, track);
+#else
+      player_playFolder(folder, track);
+#endif
+      displaySetPage(DISPLAY_PAGE_PLAYER);
+    } else {
+      displaySetPage(DISPLAY_PAGE_BROWSER);
+    }
+  } else if (event.shortPress & INPUT_BUTTON_VOL_DOWN) {
+    displaySetPage(browser_back() ? DISPLAY_PAGE_PLAYER : DISPLAY_PAGE_BROWSER);
+  }
+}
+#endif
+
+/**
+ * @brief Input task, map buttons & encoder to page shown
+ */
+void inputTask() {
+  struct input_event event = input_poll();
+
+  if (bootState != BOOT_DONE) {
+    return;
+  }
+
+#if (BROWSER_ENABLE == 1)
+  if (displayPage == DISPLAY_PAGE_BROWSER) {
+    browserInput(event);
+  } else {
+    playerInput(event);
+  }
+#else
+  playerInput(event);
+#endif
+
+#if (ENCODER_ENABLE == 1)
+  if (scheduler_millis() - encoderSampled >= ENCODER_SAMPLE_PERIOD) {
+    encoderSampled = scheduler_millis();
+    encoderSample();
+  }
+#endif
+}
 
 /**
  * @brief Main function
@@ -155,35 +831,36 @@ int main(void) {
   NVIC_PriorityGroupConfig(NVIC_PriorityGroup_1);
   SystemCoreClockUpdate();
   Delay_Init();
+  // debug output never goes to USART1, it is the player link
 #if (SDI_PRINT == SDI_PR_OPEN)
   SDI_Printf_Enable();
-#else
-  USART_Printf_Init(115200);
+#elif (SDI_PRINT == SDI_PR_SOFT)
+  softuart_init();
 #endif
   printf("SystemClk: %d\r\n", SystemCoreClock);
   printf("ChipID: %08x\r\n", DBGMCU_GetCHIPID());
 
+  // Delay_Ms() is not available from here, SysTick belongs to scheduler
+  scheduler_init();
+#if (CANVAS_BENCHMARK == 1)
+  canvas_benchmark();
+#endif
+
+  // module boots 1.5..3 sec, talk to it first & bring up everything else meanwhile
   initUSART1();
+  bootStart();
+
   initI2C1();
+  input_init();
+#if (ENCODER_ENABLE == 1)
+  encoder_init();
+#endif
   
   display_init();
-  player_reset();
-  //Delay_Ms(PLAYER_BOOT_DELAY);
-  while (pReady == 0) {
-    Delay_Ms(100);
-  }
-  
-  player_setVolume(15);
-  Delay_Ms(PLAYER_CMD_DELAY);
+  displaySetPage(DISPLAY_PAGE_BOOT);
 
-  player_repeatFolder(2);
-  Delay_Ms(PLAYER_CMD_DELAY);
-  
-  //player_repeatAll(1);
-
-  while (1) {
-    displayShow();
-
-    Delay_Ms(200);
-  }
+  scheduler_add(SCHEDULER_TASK_PLAYER, playerTask, 0);
+  scheduler_add(SCHEDULER_TASK_DISPLAY, displayTask, 50);
+  scheduler_add(SCHEDULER_TASK_INPUT, inputTask, INPUT_POLL_PERIOD);
+  scheduler_run();
 }
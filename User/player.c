@@ -3,25 +3,61 @@
 #include <string.h>
 #include "debug.h"
 #include "player.h"
+#include "scheduler.h"
 
-const enum player_module pModule = PLAYER_MINI; 
+enum player_module pModule = PLAYER_MINI; // detected at boot, see variant.c
 const uint8_t pAck = 0x01; // 0x01 = module return feedback after the command, 0x00 = module not return feedback after the command
 enum player_callback pCallback = PLAYER_CALLBACK_UNDEFINED;
 
 uint8_t txBuffer[PLAYER_UART_FRAME_SIZE];
 uint8_t rxBuffer[PLAYER_UART_FRAME_SIZE];
 uint8_t rxPos = 0;
+uint8_t rxQueue[PLAYER_RX_QUEUE_SIZE][PLAYER_UART_FRAME_SIZE];
+volatile uint8_t rxHead = 0;
+volatile uint8_t rxTail = 0;
+struct player_command txQueue[PLAYER_TX_QUEUE_SIZE];
+uint8_t txCount = 0;
+uint8_t txBusy = 0;   // command in flight, waiting for ACK or timeout
+uint32_t txSent = -PLAYER_CMD_DELAY; // msec of last transmit, first command goes out at once
+uint8_t txClass = PLAYER_PACE_SYSTEM; // pace class of last transmitted command
+struct player_pace pPace[PLAYER_PACE_CLASSES];
+uint8_t pFallback = PLAYER_PACE_FALLBACK; // commands left with conservative pacing
+struct player_lane_stats pLanes[PLAYER_LANES];
+struct player_command txLast;   // last transmitted command, sent again on recoverable error
+uint16_t txBackoff = 0;         // extra spacing before next transmit, msec
+uint8_t pRetries = 0;           // retries of txLast
+uint8_t pSkips = 0;             // missing tracks skipped in a row
+uint8_t pErrorRun = 0;          // errors since last clean reply
+uint16_t pErrors[PLAYER_ERROR_CLASSES];
 uint8_t pReady = 0;
 uint8_t pDone = 0;
 uint8_t pOk = 0;
 uint8_t pSource = 0;
+uint8_t pDevice = 0;          // last PLAYER_SET_SOURCE value, 0 = module picked source itself
 uint16_t pError = 0;
+uint8_t pState = PLAYER_STATE_STOPPED;
+uint8_t pAdvert = 0;          // advert clip playing, main track is interrupted
+uint16_t pDoneLast = 0;       // value of last DONE, track or advert clip
+uint32_t pDoneAt = 0;         // msec of it, repeated DONE is dropped
 
 uint8_t pFolder = 2;
 uint8_t pFolders = 0;
 uint16_t pTrack = 1;
 uint16_t pVolume = 15;
 uint16_t pTotalTrack = 0;
+uint8_t pEqualizer = 0;
+uint8_t pMode = PLAYER_MODE_NONE;
+uint16_t pAnswers = 0; // answered queries, bit = cmd - PLAYER_GET_STATUS
+uint8_t pQueryFolder = 0;   // folder of last sent PLAYER_GET_QNT_FOLDER_FILES
+uint16_t pFolderTracks = 0; // answer to it
+uint16_t pCache[PLAYER_CACHE_SIZE]; // last answer per query, valid if bit in pCached is set
+uint16_t pCached = 0;
+uint8_t pCacheFolder = 0;           // folder of cached PLAYER_GET_QNT_FOLDER_FILES
+uint16_t pCacheHits = 0;
+uint16_t pCacheMisses = 0;
+struct player_event eQueue[PLAYER_EVENT_QUEUE_SIZE];
+uint8_t eHead = 0;
+uint8_t eTail = 0;
 
 /**
  * @brief Write buffer to USART1
@@ -36,7 +72,7 @@ void player_write(uint8_t size) {
 }
 
 /**
- * @brief Send data to player
+ * @brief Transmit command to player
  * Send data via Serial port
  *   NOTE:
  *   - DFPlayer TX data frame format:
@@ -44,7 +80,7 @@ void player_write(uint8_t size) {
  *     START, VER, LEN, CMD, ACK, DH, DL, SUMH, SUML, END
  *            -------- checksum --------
  */
-void player_send(uint8_t cmd, uint8_t dh, uint8_t dl) {
+void player_transmit(uint8_t cmd, uint8_t dh, uint8_t dl) {
   txBuffer[0] = PLAYER_UART_START_BYTE;
   txBuffer[1] = PLAYER_UART_VERSION;
   txBuffer[2] = PLAYER_UART_DATA_LEN;
@@ -80,11 +116,6 @@ void player_send(uint8_t cmd, uint8_t dh, uint8_t dl) {
       txBuffer[8] = checksum;
       txBuffer[9] = PLAYER_UART_END_BYTE;
       player_write(PLAYER_UART_FRAME_SIZE);
-
-      // GD3200B/MH2024K chip so slow & need delay after write command
-      if (pModule == PLAYER_HW_247A) {	
-        Delay_Ms(PLAYER_CMD_DELAY);
-      }
       break;
 
     case PLAYER_NO_CHECKSUM:
@@ -95,6 +126,215 @@ void player_send(uint8_t cmd, uint8_t dh, uint8_t dl) {
   }
 }
 
+/**
+ * @brief Find pending command
+ *
+ * @return queue index, -1 = not queued
+ */
+int8_t player_pending(uint8_t cmd) {
+  for (uint8_t i = 0; i < txCount; i++) {
+    if (txQueue[i].cmd == cmd) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Drop pending command from queue
+ */
+void player_unqueue(uint8_t i) {
+  txCount--;
+  memmove(&txQueue[i], &txQueue[i + 1], (txCount - i) * sizeof(txQueue[0]));
+}
+
+/**
+ * @brief Merge command into pending one
+ * NOTE:
+ *  - settings (volume, EQ, DAC, source, folder) are absolute, only new value is kept
+ *  - play/pause/stop only last one matters
+ *  - queries are not repeated while same query is pending
+ *  - pending one is dropped & new one queued at tail, so it never overtakes commands queued in between
+ */
+void player_coalesce(uint8_t cmd, uint8_t dh, uint8_t dl) {
+  int8_t i;
+
+  switch (cmd) {
+    case PLAYER_SET_VOLUME:
+    case PLAYER_SET_EQUALIZER:
+    case PLAYER_SET_SOURCE:
+    case PLAYER_SET_DAC_GAIN:
+    case PLAYER_SET_DAC:
+    case PLAYER_PLAY_FOLDER:
+      i = player_pending(cmd);
+      break;
+
+    case PLAYER_PLAY:
+    case PLAYER_PAUSE:
+    case PLAYER_STOP:
+      i = player_pending(PLAYER_PLAY);
+      if (i < 0) {
+        i = player_pending(PLAYER_PAUSE);
+      }
+      if (i < 0) {
+        i = player_pending(PLAYER_STOP);
+      }
+      break;
+
+    default:
+      if (cmd < PLAYER_GET_STATUS || cmd > PLAYER_GET_QNT_FOLDERS) {
+        return;
+      }
+      i = player_pending(cmd);
+      if (i >= 0 && (txQueue[i].dh != dh || txQueue[i].dl != dl)) {
+        return;
+      }
+      break;
+  }
+
+  if (i >= 0) {
+    player_unqueue(i);
+  }
+}
+
+/**
+ * @brief Keep cached query results in line with command sent to module
+ * NOTE:
+ *  - absolute settings are written through, no query is needed to read them back
+ *  - loop & random commands change play mode, source & reset change everything
+ */
+void player_cacheCommand(uint8_t cmd, uint8_t dl) {
+  switch (cmd) {
+    case PLAYER_SET_VOLUME:
+      // user volume, fade levels of player_setLevel() are never cached
+      pCache[PLAYER_GET_VOL - PLAYER_GET_STATUS] = pVolume;
+      pCached |= PLAYER_CACHE_BIT(PLAYER_GET_VOL);
+      break;
+
+    case PLAYER_SET_EQUALIZER:
+      pCache[PLAYER_GET_EQ - PLAYER_GET_STATUS] = dl;
+      pCached |= PLAYER_CACHE_BIT(PLAYER_GET_EQ);
+      break;
+
+    case PLAYER_REPEATE_TRACK:
+    case PLAYER_REPEAT_ALL:
+    case PLAYER_REPEAT_FOLDER:
+    case PLAYER_RANDOM_ALL_FILES:
+    case PLAYER_LOOP_CURRENT_TRACK:
+      player_invalidate(PLAYER_CACHE_BIT(PLAYER_GET_PLAY_MODE));
+      break;
+
+    case PLAYER_SET_SOURCE:
+    case PLAYER_RESET:
+      player_invalidate(PLAYER_CACHE_ALL);
+      break;
+  }
+}
+
+/**
+ * @brief Queue command in lane
+ * NOTE:
+ *  - user command goes after other user commands but before all background ones,
+ *    so it waits for one in-flight frame at most
+ *  - full queue gives up last background command for user command
+ */
+void player_enqueue(uint8_t cmd, uint8_t dh, uint8_t dl, uint8_t lane) {
+  uint8_t i;
+
+  player_coalesce(cmd, dh, dl);
+  i = txCount;
+
+  if (txCount == PLAYER_TX_QUEUE_SIZE) {
+    if (lane == PLAYER_LANE_BACKGROUND || txQueue[txCount - 1].lane == PLAYER_LANE_USER) {
+      printf("Queue full, cmd: %02x dropped\r\n", cmd);
+      return;
+    }
+    printf("Queue full, cmd: %02x dropped\r\n", txQueue[txCount - 1].cmd);
+    txCount--;
+    i = txCount;
+  }
+
+  if (lane == PLAYER_LANE_USER) {
+    i = 0;
+    while (i < txCount && txQueue[i].lane == PLAYER_LANE_USER) {
+      i++;
+    }
+    memmove(&txQueue[i + 1], &txQueue[i], (txCount - i) * sizeof(txQueue[0]));
+  }
+
+  txQueue[i].cmd = cmd;
+  txQueue[i].dh = dh;
+  txQueue[i].dl = dl;
+  txQueue[i].lane = lane;
+  txQueue[i].queued = scheduler_millis();
+  txCount++;
+  // only now, command dropped on full queue never reaches module
+  player_cacheCommand(cmd, dl);
+}
+
+/**
+ * @brief Queue command for player, player_task() transmits it when link is free
+ */
+void player_send(uint8_t cmd, uint8_t dh, uint8_t dl) {
+  player_enqueue(cmd, dh, dl, PLAYER_LANE_USER);
+}
+
+/**
+ * @brief Queue command in front of all pending ones, used by error recovery
+ * NOTE:
+ *  - last pending command is dropped when queue is full
+ */
+void player_sendFirst(uint8_t cmd, uint8_t dh, uint8_t dl) {
+  if (txCount == PLAYER_TX_QUEUE_SIZE) {
+    txCount--;
+  }
+  memmove(&txQueue[1], &txQueue[0], txCount * sizeof(txQueue[0]));
+  txQueue[0].cmd = cmd;
+  txQueue[0].dh = dh;
+  txQueue[0].dl = dl;
+  txQueue[0].lane = PLAYER_LANE_USER;
+  txQueue[0].queued = scheduler_millis();
+  txCount++;
+  player_cacheCommand(cmd, dl);
+}
+
+/**
+ * @brief Merge next/previous into pending absolute jump
+ * NOTE:
+ *  - only pending PLAY_FOLDER is merged, next/previous are kept as is, so folder repeat mode is kept
+ *  - merged jump is queued again at tail, it never overtakes commands queued in between
+ *  - pTrack must already hold target track
+ *
+ * @return 1 = merged
+ */
+uint8_t player_navigate() {
+  int8_t i = player_pending(PLAYER_PLAY_FOLDER);
+
+  if (i < 0) {
+    return 0;
+  }
+
+  player_unqueue(i);
+  player_send(PLAYER_PLAY_FOLDER, pFolder, pTrack);
+  return 1;
+}
+
+/**
+ * @brief Track number after step, wraps when folder size is known
+ */
+uint16_t player_stepTrack(int8_t step) {
+  int16_t track = pTrack + step;
+  uint16_t last = (pTotalTrack > 0) ? pTotalTrack : PLAYER_FOLDER_TRACKS;
+
+  if (track < 1) {
+    return (pTotalTrack > 0) ? last : 1;
+  }
+  if (track > last) {
+    return (pTotalTrack > 0) ? 1 : last;
+  }
+  return track;
+}
+
 /**
  * @brief Read data from player
  * Read MP3 player command feedback
@@ -137,7 +377,12 @@ uint16_t player_response(uint8_t cmd) {
  *  - don’t copy 0003.mp3 & then 0001.mp3, because 0003.mp3 will be played first
  */
 void player_playNext() {
-  player_send(PLAYER_PLAY_NEXT, 0, 0);
+  pTrack = player_stepTrack(1);
+  if (!player_navigate()) {
+    player_send(PLAYER_PLAY_NEXT, 0, 0);
+  }
+  pState = PLAYER_STATE_PLAYING;
+  pSkips = 0;
 }
 
 /**
@@ -148,7 +393,12 @@ void player_playNext() {
  *  - don’t copy 0003.mp3 & then 0001.mp3, because 0003.mp3 will be played first
  */
 void player_playPrevious() {
-  player_send(PLAYER_PLAY_PREVIOUS, 0, 0);
+  pTrack = player_stepTrack(-1);
+  if (!player_navigate()) {
+    player_send(PLAYER_PLAY_PREVIOUS, 0, 0);
+  }
+  pState = PLAYER_STATE_PLAYING;
+  pSkips = 0;
 }
 
 /**
@@ -160,20 +410,29 @@ void player_playPrevious() {
  */
 void player_playTrack(uint16_t track) {
   player_send(PLAYER_PLAY_TRACK, (track >> 8), track);
+  pState = PLAYER_STATE_PLAYING;
 }
 
 /**
  * @brief Increase volume
+ * NOTE:
+ *  - sent as absolute volume, so repeated steps merge into one command
  */
 void player_volumeUp() {
-  player_send(PLAYER_SET_VOLUME_UP, 0, 0);
+  if (pVolume < PLAYER_VOLUME_MAX) {
+    player_setVolume(pVolume + 1);
+  }
 }
 
 /**
  * @brief Decrease volume
+ * NOTE:
+ *  - sent as absolute volume, so repeated steps merge into one command
  */
 void player_volumeDown() {
-  player_send(PLAYER_SET_VOLUME_DOWN, 0, 0);
+  if (pVolume > 0) {
+    player_setVolume(pVolume - 1);
+  }
 }
 
 /**
@@ -181,8 +440,19 @@ void player_volumeDown() {
  * NOTE: Volume level: 0-30
  */
 void player_setVolume(uint8_t volume) {
-  player_send(PLAYER_SET_VOLUME, 0, volume);
   pVolume = volume;
+  player_send(PLAYER_SET_VOLUME, 0, volume);
+}
+
+/**
+ * @brief Set module volume, user volume pVolume is kept
+ * NOTE:
+ *  - used by fades, pending level is replaced, so steps never pile up
+ *  - player_setVolume() merges with pending level too, user input wins
+ *  - query cache keeps answering pVolume
+ */
+void player_setLevel(uint8_t volume) {
+  player_send(PLAYER_SET_VOLUME, 0, volume);
 }
 
 /**
@@ -191,6 +461,7 @@ void player_setVolume(uint8_t volume) {
  */
 void player_setEqualizer(uint8_t preset) {
   player_send(PLAYER_SET_EQUALIZER, 0, preset);
+  pEqualizer = preset;
 }
 
 /**
@@ -201,6 +472,7 @@ void player_setEqualizer(uint8_t preset) {
  */
 void player_repeatTrack(uint16_t track) {
   player_send(PLAYER_REPEATE_TRACK, (track >> 8), track);
+  pState = PLAYER_STATE_PLAYING;
 }
 
 /**
@@ -218,10 +490,12 @@ void player_repeatTrack(uint16_t track) {
  *	- module automatically detect source if source is on-line
  *	- module automatically enter standby after setting source
  *	- this command interrupt playback!!!
- *	- wait 200ms to select source
+ *	- storage is ready when module reports it, see source.c, no fixed delay
  */
 void player_setSource(uint8_t source) {
   player_send(PLAYER_SET_SOURCE, 0, source);
+  pDevice = source;
+  pState = PLAYER_STATE_STOPPED;
 }
 
 /**
@@ -255,6 +529,7 @@ void player_setNormalMode() {
  */
 void player_reset() {
   player_send(PLAYER_RESET, 0, 0);
+  pState = PLAYER_STATE_STOPPED;
 }
 
 /**
@@ -262,6 +537,7 @@ void player_reset() {
  */
 void player_play() {
   player_send(PLAYER_PLAY, 0, 0);
+  pState = PLAYER_STATE_PLAYING;
 }
 
 /**
@@ -269,6 +545,7 @@ void player_play() {
  */
 void player_pause() {
   player_send(PLAYER_PAUSE, 0, 0);
+  pState = PLAYER_STATE_PAUSED;
 }
 
 /**
@@ -276,9 +553,16 @@ void player_pause() {
  * NOTE:
  *  - folder name must be 01..99
  *  - up to 001..255 songs in each folder
+ *  - ends any loop mode, module stops after track
  */
 void player_playFolder(uint8_t folder, uint8_t track) {
   player_send(PLAYER_PLAY_FOLDER, folder, track);
+  pFolder = folder;
+  pTrack = track;
+  pMode = PLAYER_MODE_NONE;
+  pCallback = PLAYER_CALLBACK_UNDEFINED;
+  pState = PLAYER_STATE_PLAYING;
+  pSkips = 0;
 }
 
 /**
@@ -306,6 +590,7 @@ void player_setDacGain(uint8_t enable, uint8_t gain) {
  */
 void player_repeatAll(uint8_t enable) {
   player_send(PLAYER_REPEAT_ALL, 0, enable);
+  pMode = enable ? PLAYER_MODE_ALL : PLAYER_MODE_NONE;
 }
 
 /**
@@ -320,6 +605,7 @@ void player_repeatAll(uint8_t enable) {
  */
 void player_playMp3Folder(uint16_t track) {
   player_send(PLAYER_PLAY_MP3_FOLDER, (track >> 8), track);
+  pState = PLAYER_STATE_PLAYING;
 }
 
 /**
@@ -348,6 +634,7 @@ void player_playAdvertFolder(uint16_t track) {
  */
 void player_play3000Folder(uint16_t track) {
   player_send(PLAYER_PLAY_3000_FOLDER, (track >> 8), track);
+  pState = PLAYER_STATE_PLAYING;
 }
 
 /**
@@ -366,6 +653,7 @@ void player_stopAdvertFolder() {
  */
 void player_stop() {
   player_send(PLAYER_STOP, 0, 0);
+  pState = PLAYER_STATE_STOPPED;
 }
 
 /**
@@ -379,7 +667,10 @@ void player_stop() {
 void player_repeatFolder(uint8_t folder) {
   player_send(PLAYER_REPEAT_FOLDER, 0, folder);
   pFolder = folder;
+  pTrack = 1;
+  pMode = PLAYER_MODE_FOLDER;
   pCallback = PLAYER_CALLBACK_TRACK;
+  pState = PLAYER_STATE_PLAYING;
 }
 
 /**
@@ -389,6 +680,8 @@ void player_repeatFolder(uint8_t folder) {
  */
 void player_randomAll() {
   player_send(PLAYER_RANDOM_ALL_FILES, 0, 0);
+  pMode = PLAYER_MODE_RANDOM;
+  pState = PLAYER_STATE_PLAYING;
 }
 
 /**
@@ -400,6 +693,7 @@ void player_randomAll() {
  */
 void player_repeatCurrentTrack(uint8_t repeat) {
   player_send(PLAYER_LOOP_CURRENT_TRACK, 0, repeat);
+  pMode = repeat ? PLAYER_MODE_TRACK : PLAYER_MODE_NONE;
 }
 
 /**
@@ -412,41 +706,540 @@ void player_enableDac(uint8_t enable) {
   player_send(PLAYER_SET_DAC, 0, enable);
 }
 
+/**
+ * @brief Pace class of command, commands in class share latency estimate
+ */
+uint8_t player_paceClass(uint8_t cmd) {
+  switch (cmd) {
+    case PLAYER_SET_VOLUME:
+    case PLAYER_SET_EQUALIZER:
+    case PLAYER_SET_DAC_GAIN:
+    case PLAYER_SET_DAC:
+      return PLAYER_PACE_SETTING;
+
+    case PLAYER_SET_SOURCE:
+    case PLAYER_SET_SLEEP_MODE:
+    case PLAYER_SET_NORMAL_MODE:
+    case PLAYER_RESET:
+      return PLAYER_PACE_SYSTEM;
+
+    default:
+      if (cmd >= PLAYER_GET_STATUS && cmd <= PLAYER_GET_QNT_FOLDERS) {
+        return PLAYER_PACE_QUERY;
+      }
+      return PLAYER_PACE_PLAYBACK;
+  }
+}
+
+/**
+ * @brief Reset pacing to conservative PLAYER_CMD_DELAY for next PLAYER_PACE_FALLBACK commands
+ */
+void player_paceFallback() {
+  pFallback = PLAYER_PACE_FALLBACK;
+  for (uint8_t i = 0; i < PLAYER_PACE_CLASSES; i++) {
+    pPace[i].gap = PLAYER_CMD_DELAY;
+  }
+  printf("Pace fallback\r\n");
+}
+
+/**
+ * @brief Learn from reply to last transmitted command
+ * NOTE:
+ *  - reply latency: upper quantile estimate (~p90), jumps up fast, sinks slowly
+ *  - gap: extra spacing, lowered on every clean reply, reset when module reports busy or broken frame
+ */
+void player_paceReply(uint8_t cmd, uint16_t value) {
+  struct player_pace *pace = &pPace[txClass];
+  uint16_t latency = scheduler_millis() - txSent;
+
+  if (cmd == PLAYER_RETURN_ERROR && (value == PLAYER_ERROR_BUSY || value == PLAYER_ERROR_FRAME || value == PLAYER_ERROR_CHECKSUM)) {
+    player_paceFallback();
+    return;
+  }
+
+  if (pace->samples == 0 || latency > pace->reply) {
+    pace->reply += (latency - pace->reply + 1) / 2;
+    if (pace->samples == 0) {
+      pace->reply = latency;
+    }
+  } else {
+    pace->reply -= (pace->reply - latency + 15) / 16;
+  }
+  if (pace->samples < 0xFF) {
+    pace->samples++;
+  }
+
+  if (pace->gap > PLAYER_PACE_DECREASE) {
+    pace->gap -= PLAYER_PACE_DECREASE;
+  } else {
+    pace->gap = 0;
+  }
+  if (pFallback > 0) {
+    pFallback--;
+  }
+}
+
+/**
+ * @brief Minimal time between transmits after command of pace class
+ */
+uint16_t player_paceSpacingOf(uint8_t paceClass) {
+  struct player_pace *pace = &pPace[paceClass];
+
+  if (PLAYER_PACE_ENABLE == 0 || pFallback > 0 || pace->samples < PLAYER_PACE_SAMPLES) {
+    return PLAYER_CMD_DELAY;
+  }
+
+  uint16_t spacing = pace->reply + PLAYER_PACE_MARGIN + pace->gap;
+  return (spacing < PLAYER_CMD_DELAY) ? spacing : PLAYER_CMD_DELAY;
+}
+
+/**
+ * @brief Minimal time between transmits after last command
+ */
+uint16_t player_paceSpacing() {
+  return player_paceSpacingOf(txClass);
+}
+
+/**
+ * @brief Account queue -> reply latency of last transmitted command in its lane
+ */
+void player_laneReply() {
+  struct player_lane_stats *stats = &pLanes[txLast.lane];
+  uint16_t latency = (uint16_t) scheduler_millis() - txLast.queued;
+
+  if (stats->count == 0) {
+    stats->average = latency;
+  } else {
+    stats->average = stats->average + ((int16_t) (latency - stats->average)) / 8;
+  }
+  if (latency > stats->max) {
+    stats->max = latency;
+  }
+  if (stats->count < 0xFFFF) {
+    stats->count++;
+  }
+}
+
+/**
+ * @brief Map module error code to error class
+ */
+uint8_t player_errorClass(uint16_t code) {
+  switch (code) {
+    case PLAYER_ERROR_FRAME:
+    case PLAYER_ERROR_CHECKSUM:
+      return PLAYER_ERROR_CLASS_LINK;
+    case PLAYER_ERROR_BUSY:
+      return PLAYER_ERROR_CLASS_BUSY;
+    case PLAYER_ERROR_SLEEPING:
+    case PLAYER_ERROR_SLEEP_ENTERED:
+      return PLAYER_ERROR_CLASS_SLEEP;
+    case PLAYER_ERROR_TRACK_RANGE:
+    case PLAYER_ERROR_NOT_FOUND:
+      return PLAYER_ERROR_CLASS_TRACK;
+    case PLAYER_ERROR_SD_READ:
+      return PLAYER_ERROR_CLASS_MEDIA;
+    default:
+      return PLAYER_ERROR_CLASS_OTHER;
+  }
+}
+
+/**
+ * @brief Pick recovery action for error class
+ * NOTE:
+ *  - long error run means module is stuck, it is reset whatever the class is
+ *  - missing track is skipped only for playback commands, e.g. folder count query is not
+ */
+uint8_t player_recovery(uint8_t errorClass) {
+  if (pErrorRun >= PLAYER_ERROR_ESCALATE) {
+    return PLAYER_RECOVERY_RESET;
+  }
+
+  switch (errorClass) {
+    case PLAYER_ERROR_CLASS_LINK:
+    case PLAYER_ERROR_CLASS_BUSY:
+      return (pRetries < PLAYER_RETRY_MAX) ? PLAYER_RECOVERY_RETRY : PLAYER_RECOVERY_NONE;
+
+    case PLAYER_ERROR_CLASS_TRACK:
+      if (player_paceClass(txLast.cmd) != PLAYER_PACE_PLAYBACK || pSkips >= PLAYER_SKIP_MAX) {
+        return PLAYER_RECOVERY_NONE;
+      }
+      return PLAYER_RECOVERY_SKIP;
+
+    case PLAYER_ERROR_CLASS_SLEEP:
+    case PLAYER_ERROR_CLASS_MEDIA:
+      return (pRetries < PLAYER_RETRY_MAX) ? PLAYER_RECOVERY_SOURCE : PLAYER_RECOVERY_RESET;
+
+    default:
+      return PLAYER_RECOVERY_NONE;
+  }
+}
+
+/**
+ * @brief React on module error, recovery commands go in front of queue
+ * NOTE:
+ *  - retry backoff is PLAYER_RETRY_BACKOFF * 2^n msec, worst case well under a second
+ *  - reset module answers with READY, application restores playback on PLAYER_EVENT_ONLINE
+ */
+void player_recover(uint16_t code) {
+  uint8_t errorClass = player_errorClass(code);
+  uint8_t action;
+
+  pErrors[errorClass]++;
+  // refused background query, e.g. scan of missing folder, is no sign of stuck module
+  if (pErrorRun < 0xFF && txLast.lane != PLAYER_LANE_BACKGROUND) {
+    pErrorRun++;
+  }
+#if (PLAYER_RECOVERY_ENABLE == 1)
+  action = player_recovery(errorClass);
+#else
+  action = PLAYER_RECOVERY_NONE; // error is only counted & shown
+#endif
+  printf("Error %02x, class %u, cmd %02x, recovery %u\r\n", code, errorClass, txLast.cmd, action);
+
+  switch (action) {
+    case PLAYER_RECOVERY_RETRY:
+      // newer command of same kind is pending, it replaces retry
+      if (player_pending(txLast.cmd) >= 0) {
+        break;
+      }
+      player_sendFirst(txLast.cmd, txLast.dh, txLast.dl);
+      txBackoff = PLAYER_RETRY_BACKOFF << pRetries;
+      pRetries++;
+      break;
+
+    case PLAYER_RECOVERY_SKIP:
+      pSkips++;
+      pTrack = player_stepTrack(1);
+      if (!player_navigate()) {
+        player_sendFirst(PLAYER_PLAY_FOLDER, pFolder, pTrack);
+      }
+      if (pSkips >= PLAYER_SKIP_MAX) {
+        printf("Too many missing tracks\r\n");
+      }
+      break;
+
+    case PLAYER_RECOVERY_SOURCE:
+      player_sendFirst(txLast.cmd, txLast.dh, txLast.dl);
+      // source picked by application, else the one module starts with
+      player_sendFirst(PLAYER_SET_SOURCE, 0, pDevice ? pDevice : (pSource & PLAYER_SOURCE_TF || !(pSource & PLAYER_SOURCE_USB)) ? 2 : 1);
+      txBackoff = PLAYER_RETRY_BACKOFF << pRetries;
+      pRetries++;
+      break;
+
+    case PLAYER_RECOVERY_RESET:
+      txCount = 0;
+      player_sendFirst(PLAYER_RESET, 0, 0);
+      pState = PLAYER_STATE_STOPPED;
+      pErrorRun = 0;
+      pRetries = 0;
+      break;
+
+    case PLAYER_RECOVERY_NONE:
+      if (errorClass == PLAYER_ERROR_CLASS_TRACK && player_paceClass(txLast.cmd) == PLAYER_PACE_PLAYBACK) {
+        pState = PLAYER_STATE_STOPPED;
+      }
+      pRetries = 0;
+      break;
+  }
+}
+
+/**
+ * @brief Queue event for application
+ * NOTE:
+ *  - oldest event is dropped when queue is full
+ */
+void player_event(uint8_t type, uint16_t value) {
+  uint8_t next = (eHead + 1) % PLAYER_EVENT_QUEUE_SIZE;
+  if (next == eTail) {
+    eTail = (eTail + 1) % PLAYER_EVENT_QUEUE_SIZE;
+  }
+  eQueue[eHead].type = type;
+  eQueue[eHead].value = value;
+  eHead = next;
+}
+
+/**
+ * @brief Take next event
+ *
+ * @return 1 = event copied, 0 = queue empty
+ */
+uint8_t player_getEvent(struct player_event *event) {
+  if (eTail == eHead) {
+    return 0;
+  }
+  *event = eQueue[eTail];
+  eTail = (eTail + 1) % PLAYER_EVENT_QUEUE_SIZE;
+  return 1;
+}
+
 /**
  * @brief Process return code
  */
-void player_return() {
-  uint8_t cmd = rxBuffer[3];
-  uint16_t value = ((uint16_t) rxBuffer[5] << 8) | rxBuffer[6];
+void player_return(uint8_t *frame) {
+  uint8_t cmd = frame[3];
+  uint16_t value = ((uint16_t) frame[5] << 8) | frame[6];
   printf("Response cmd: %02x, val: %04x\r\n", cmd, value);
 
+  if (txBusy && (cmd == PLAYER_RETURN_CODE_OK_ACK || cmd == PLAYER_RETURN_ERROR
+      || (cmd >= PLAYER_GET_STATUS && cmd <= PLAYER_GET_QNT_FOLDERS))) {
+    txBusy = 0;
+#if (PLAYER_PACE_ENABLE == 1)
+    player_paceReply(cmd, value);
+#endif
+    player_laneReply();
+  }
+
   switch (cmd) {
     case PLAYER_RETURN_CODE_DONE:
       printf("Done\r\n");
+      if (value == pDoneLast && scheduler_millis() - pDoneAt < PLAYER_DONE_REPEAT) {
+        break; // module repeats DONE, track or advert is already finished
+      }
+      pDoneLast = value;
+      pDoneAt = scheduler_millis();
+      if (pAdvert) {
+        // advert finished, module resumes main track by itself
+        pAdvert = 0;
+        player_event(PLAYER_EVENT_ADVERT_DONE, value);
+        break;
+      }
       pDone = 1;
+      pSkips = 0; // track played, folder has playable tracks
       switch (pCallback) {
         case PLAYER_CALLBACK_TRACK:
-          pTotalTrack = value;
+          // module went on to next track of folder, wraps after last one
+          pTrack = player_stepTrack(1);
           break;
         case PLAYER_CALLBACK_UNDEFINED:
+          if (pMode == PLAYER_MODE_NONE) {
+            pState = PLAYER_STATE_STOPPED; // no loop mode, module stops after track
+          }
           break;
       }
+      player_event(PLAYER_EVENT_DONE, value);
       break;
   
     case PLAYER_RETURN_CODE_READY:
       printf("Ready\r\n");
       pSource = value;
       pReady = 1;
+      player_invalidate(PLAYER_CACHE_ALL);
+      player_event(PLAYER_EVENT_ONLINE, value);
+      break;
+
+    case PLAYER_RETURN_CODE_INSERTED:
+      printf("Inserted: %02x\r\n", value);
+      player_invalidate(PLAYER_CACHE_COUNTS);
+      pSource |= value;
+      player_event(PLAYER_EVENT_INSERTED, value);
+      break;
+
+    case PLAYER_RETURN_CODE_REMOVED:
+      printf("Removed: %02x\r\n", value);
+      player_invalidate(PLAYER_CACHE_COUNTS);
+      pSource &= ~value;
+      player_event(PLAYER_EVENT_REMOVED, value);
       break;
 
     case PLAYER_RETURN_ERROR:
-      printf("Error: %04x\r\n", value);
       pError = value;
+      if (value == PLAYER_ERROR_ADVERT && pAdvert) {
+        // nothing playing to interrupt, clip is not played
+        pAdvert = 0;
+        player_event(PLAYER_EVENT_ADVERT_DONE, 0);
+      }
+      player_recover(value);
       break;
     
     case PLAYER_RETURN_CODE_OK_ACK:
       printf("Ok\r\n");
       pOk = 1;
+      pErrorRun = 0;
+      pRetries = 0;
+      break;
+
+    case PLAYER_GET_STATUS:
+      // DH = source, DL = 0 stopped, 1 playing, 2 paused
+      pSource = value >> 8;
+      switch (value & 0xFF) {
+        case 1:
+          pState = PLAYER_STATE_PLAYING;
+          break;
+        case 2:
+          pState = PLAYER_STATE_PAUSED;
+          break;
+        default:
+          pState = PLAYER_STATE_STOPPED;
+          break;
+      }
+      break;
+
+    case PLAYER_GET_VOL:
+      pVolume = value;
+      break;
+
+    case PLAYER_GET_EQ:
+      pEqualizer = value;
+      break;
+
+    case PLAYER_GET_PLAY_MODE:
+      pMode = value;
+      break;
+
+    case PLAYER_GET_QNT_FOLDER_FILES:
+      // answer has no folder number, it belongs to last sent query
+      pFolderTracks = value;
+      if (pQueryFolder == pFolder) {
+        pTotalTrack = value;
+      }
+      break;
+
+    case PLAYER_GET_QNT_FOLDERS:
+      pFolders = value;
+      break;
+  }
+
+  if (cmd >= PLAYER_GET_STATUS && cmd <= PLAYER_GET_QNT_FOLDERS) {
+    pAnswers |= 1 << (cmd - PLAYER_GET_STATUS);
+    pCache[cmd - PLAYER_GET_STATUS] = value;
+    if (PLAYER_CACHE_ALL & PLAYER_CACHE_BIT(cmd)) {
+      pCached |= PLAYER_CACHE_BIT(cmd);
+    }
+    if (cmd == PLAYER_GET_QNT_FOLDER_FILES) {
+      pCacheFolder = pQueryFolder;
+    }
+  }
+}
+
+/**
+ * @brief Queue received frame, called from USART1 interrupt
+ * NOTE:
+ *  - frame is dropped if player task is PLAYER_RX_QUEUE_SIZE frames behind
+ */
+void player_received() {
+  uint8_t next = (rxHead + 1) % PLAYER_RX_QUEUE_SIZE;
+  if (next == rxTail) {
+    return;
+  }
+  memcpy(rxQueue[rxHead], rxBuffer, PLAYER_UART_FRAME_SIZE);
+  rxHead = next;
+}
+
+/**
+ * @brief Player task, process received frames outside of interrupt & transmit queued commands
+ * NOTE:
+ *  - one command in flight, next one after ACK/response or PLAYER_CMD_DELAY timeout
+ */
+void player_task() {
+  while (rxTail != rxHead) {
+    player_return(rxQueue[rxTail]);
+    rxTail = (rxTail + 1) % PLAYER_RX_QUEUE_SIZE;
+  }
+
+  uint32_t now = scheduler_millis();
+  if (txBusy && now - txSent >= PLAYER_CMD_DELAY) {
+    txBusy = 0;
+    if (pAck) {
+      player_paceFallback(); // ACK expected, but lost
+    }
+  }
+  if (txBusy || txCount == 0 || now - txSent < player_paceSpacing() + txBackoff) {
+    return;
+  }
+
+  player_transmit(txQueue[0].cmd, txQueue[0].dh, txQueue[0].dl);
+  txLast = txQueue[0];
+  txBackoff = 0;
+  switch (txQueue[0].cmd) {
+    case PLAYER_GET_QNT_FOLDER_FILES:
+      pQueryFolder = txQueue[0].dl;
+      break;
+    case PLAYER_PLAY_ADVERT_FOLDER:
+      pAdvert = 1; // DONE from now on belongs to clip, not to main track
+      break;
+    case PLAYER_STOP_ADVERT_FOLDER:
+      pAdvert = 0;
       break;
   }
-}
\ No newline at end of file
+  txSent = now;
+  txBusy = 1;
+  txClass = player_paceClass(txQueue[0].cmd);
+
+  txCount--;
+  memmove(&txQueue[0], &txQueue[1], txCount * sizeof(txQueue[0]));
+}
+
+/**
+ * @brief Check command is queued or waits for its reply
+ */
+uint8_t player_queued(uint8_t cmd) {
+  return player_pending(cmd) >= 0 || (txBusy && txLast.cmd == cmd);
+}
+
+/**
+ * @brief Check all queued commands are sent & answered
+ */
+uint8_t player_idle() {
+  return txCount == 0 && !txBusy;
+}
+
+/**
+ * @brief Queue query, answer is stored in player state (pVolume, pEqualizer, ...) when it arrives
+ * NOTE:
+ *  - poll player_answered() to know answer arrived
+ *  - param is DL, e.g. folder for PLAYER_GET_QNT_FOLDER_FILES
+ *  - queries go to background lane, user commands overtake them
+ */
+void player_query(uint8_t cmd, uint8_t param) {
+  pAnswers &= ~(1 << (cmd - PLAYER_GET_STATUS));
+  player_enqueue(cmd, 0, param, PLAYER_LANE_BACKGROUND);
+}
+
+/**
+ * @brief Check query was answered since player_query()
+ */
+uint8_t player_answered(uint8_t cmd) {
+  return (pAnswers >> (cmd - PLAYER_GET_STATUS)) & 1;
+}
+
+/**
+ * @brief Read query result from cache, on miss query is queued
+ * NOTE:
+ *  - status & current track change by themselves, they are never cached, use player_query()
+ *  - folder track count is cached for last asked folder only, see library for all folders
+ *
+ * @return 1 = value is valid, 0 = miss, poll again later
+ */
+uint8_t player_get(uint8_t cmd, uint8_t param, uint16_t *value) {
+  if ((pCached & PLAYER_CACHE_BIT(cmd)) && (cmd != PLAYER_GET_QNT_FOLDER_FILES || pCacheFolder == param)) {
+    *value = pCache[cmd - PLAYER_GET_STATUS];
+    pCacheHits++;
+    return 1;
+  }
+
+  pCacheMisses++;
+  if (!(txBusy && txLast.cmd == cmd && txLast.dl == param)) {
+    player_query(cmd, param); // pending duplicate is merged
+  }
+  return 0;
+}
+
+/**
+ * @brief Drop cached query results, mask of PLAYER_CACHE_BIT()
+ */
+void player_invalidate(uint16_t mask) {
+  pCached &= ~mask;
+}
+
+/**
+ * @brief Print lane latency, cache & error counters to debug channel
+ */
+void player_report() {
+  printf("Lanes user: %u avg %u max %u ms, background: %u avg %u max %u ms\r\n",
+    pLanes[PLAYER_LANE_USER].count, pLanes[PLAYER_LANE_USER].average, pLanes[PLAYER_LANE_USER].max,
+    pLanes[PLAYER_LANE_BACKGROUND].count, pLanes[PLAYER_LANE_BACKGROUND].average, pLanes[PLAYER_LANE_BACKGROUND].max);
+  printf("Cache hits: %u, misses: %u\r\n", pCacheHits, pCacheMisses);
+  printf("Errors link: %u, busy: %u, sleep: %u, track: %u, media: %u, other: %u\r\n",
+    pErrors[PLAYER_ERROR_CLASS_LINK], pErrors[PLAYER_ERROR_CLASS_BUSY], pErrors[PLAYER_ERROR_CLASS_SLEEP],
+    pErrors[PLAYER_ERROR_CLASS_TRACK], pErrors[PLAYER_ERROR_CLASS_MEDIA], pErrors[PLAYER_ERROR_CLASS_OTHER]);
+}
@@ -16,6 +16,9 @@ extern "C" {
 #define PLAYER_UART_VERSION         0xFF // Protocol version
 #define PLAYER_UART_DATA_LEN        0x06 // Number of data bytes, except start byte, checksum & end byte
 #define PLAYER_UART_END_BYTE        0xEF // End byte
+#define PLAYER_RX_QUEUE_SIZE        4    // Received frames waiting for player task
+#define PLAYER_TX_QUEUE_SIZE        8    // Commands waiting for transmit, bursts are merged so it rarely fills
+#define PLAYER_EVENT_QUEUE_SIZE     4    // Module notifications waiting for application
 
 /* command controls */
 #define PLAYER_PLAY_NEXT            0x01 // Play next uploaded file
@@ -47,8 +50,10 @@ extern "C" {
 #define PLAYER_PLAY_ADVERT_FOLDER_N 0x25 // Interrupt current track & play track number 001..255 from "advert1".."advert9" folder, than resume current track (may not be supported by some modules)
 
 /* request command controls */
+#define PLAYER_RETURN_CODE_INSERTED 0x3A // Storage inserted, value = source mask
+#define PLAYER_RETURN_CODE_REMOVED  0x3B // Storage removed, value = source mask
 #define PLAYER_RETURN_CODE_DONE     0x3D // Track playback is is completed, module return this status automatically after the track has been played
-#define PLAYER_RETURN_CODE_READY    0x3F // Ready after boot or reset, module return this status automatically after boot or reset
+#define PLAYER_RETURN_CODE_READY    0x3F // Ready after boot or reset, module return this status automatically after boot or reset, value = online source mask
 #define PLAYER_RETURN_ERROR         0x40 // Error, module return this status automatically if command is not accepted (details located in 7-th RX byte)
 #define PLAYER_RETURN_CODE_OK_ACK   0x41 // OK, command is accepted (returned only if ACK/feedback byte is set to 0x01)
 #define PLAYER_GET_STATUS           0x42 // Get current stutus, see NOTE
@@ -68,6 +73,24 @@ extern "C" {
 /* misc */
 #define PLAYER_BOOT_DELAY           3000 // Average player boot time 1500sec..3000msec, depends on SD-card size
 #define PLAYER_CMD_DELAY            350  // Average read command timeout 200msec..300msec for YX5200/AAxxxx chip & 350msec..500msec for GD3200B/MH2024K chip
+#ifndef PLAYER_PACE_ENABLE
+#define PLAYER_PACE_ENABLE          0    // 1 = command spacing learned from reply latency, 0 = always PLAYER_CMD_DELAY
+#endif
+#define PLAYER_PACE_MARGIN          20   // Added to measured reply latency, msec
+#define PLAYER_PACE_DECREASE        10   // Extra spacing removed per clean reply, msec
+#define PLAYER_PACE_SAMPLES         4    // Replies measured before spacing is trusted
+#define PLAYER_PACE_FALLBACK        8    // Commands sent with PLAYER_CMD_DELAY after error
+#ifndef PLAYER_RECOVERY_ENABLE
+#define PLAYER_RECOVERY_ENABLE      0    // 1 = retry, skip, wake or reset module on error, 0 = error is only counted
+#endif
+#define PLAYER_RETRY_BACKOFF        100  // Extra spacing before first retry after busy/broken frame, doubled per retry, msec
+#define PLAYER_RETRY_MAX            3    // Retries of one command before it is dropped
+#define PLAYER_SKIP_MAX             5    // Missing tracks skipped in a row before playback stops
+#define PLAYER_ERROR_ESCALATE       8    // Errors in a row without clean reply before module reset
+#define PLAYER_CACHE_SIZE           (PLAYER_GET_QNT_FOLDERS - PLAYER_GET_STATUS + 1) // One cache slot per query command
+#define PLAYER_VOLUME_MAX           30   // Volume range 0..30
+#define PLAYER_FOLDER_TRACKS        255  // Max track number in folder for PLAYER_PLAY_FOLDER
+#define PLAYER_DONE_REPEAT          200  // Same DONE again within it is a repeat, msec
 
 /* List of supported modules */
 enum player_module {
@@ -77,6 +100,120 @@ enum player_module {
   PLAYER_NO_CHECKSUM  // no checksum calculation, not recomended for MCU without external crystal oscillator
 };
 
+/* Playback state, tracked from sent commands */
+enum player_state {
+  PLAYER_STATE_STOPPED,
+  PLAYER_STATE_PLAYING,
+  PLAYER_STATE_PAUSED,
+};
+
+/* Loop mode, PLAYER_GET_PLAY_MODE answer */
+enum player_mode {
+  PLAYER_MODE_ALL,
+  PLAYER_MODE_FOLDER,
+  PLAYER_MODE_TRACK,
+  PLAYER_MODE_RANDOM,
+  PLAYER_MODE_NONE,
+};
+
+/* Source mask in inserted/removed/ready notifications */
+#define PLAYER_SOURCE_USB           0x01
+#define PLAYER_SOURCE_TF            0x02
+#define PLAYER_SOURCE_PC            0x04
+#define PLAYER_SOURCE_FLASH         0x08
+
+/* Error codes in PLAYER_RETURN_ERROR */
+#define PLAYER_ERROR_BUSY           0x01 // Module busy, e.g. still initializing
+#define PLAYER_ERROR_SLEEPING       0x02 // Module in sleep mode
+#define PLAYER_ERROR_FRAME          0x03 // Serial frame not fully received
+#define PLAYER_ERROR_CHECKSUM       0x04 // Checksum mismatch
+#define PLAYER_ERROR_TRACK_RANGE    0x05 // Track out of scope
+#define PLAYER_ERROR_NOT_FOUND      0x06 // Track not found
+#define PLAYER_ERROR_ADVERT         0x07 // Advert only while playing
+#define PLAYER_ERROR_SD_READ        0x08 // SD-card read failed
+#define PLAYER_ERROR_SLEEP_ENTERED  0x0A // Entered into sleep mode
+
+/* Error classes, each has own recovery & counter */
+enum player_error_class {
+  PLAYER_ERROR_CLASS_LINK,  // frame or checksum error, command is sent again
+  PLAYER_ERROR_CLASS_BUSY,  // module not ready, command is sent again after backoff
+  PLAYER_ERROR_CLASS_SLEEP, // module sleeps, source is selected to wake it
+  PLAYER_ERROR_CLASS_TRACK, // track out of scope or missing, next track is played
+  PLAYER_ERROR_CLASS_MEDIA, // storage read failed, source is selected again
+  PLAYER_ERROR_CLASS_OTHER, // advert while stopped, unknown codes, ignored
+  PLAYER_ERROR_CLASSES
+};
+
+/* Recovery actions */
+enum player_recovery {
+  PLAYER_RECOVERY_NONE,
+  PLAYER_RECOVERY_RETRY,
+  PLAYER_RECOVERY_SKIP,
+  PLAYER_RECOVERY_SOURCE,
+  PLAYER_RECOVERY_RESET,
+};
+
+/* Cached query results, bit = cmd - PLAYER_GET_STATUS */
+#define PLAYER_CACHE_BIT(cmd)       (1 << ((cmd) - PLAYER_GET_STATUS))
+#define PLAYER_CACHE_SETTINGS       (PLAYER_CACHE_BIT(PLAYER_GET_VOL) | PLAYER_CACHE_BIT(PLAYER_GET_EQ) | PLAYER_CACHE_BIT(PLAYER_GET_PLAY_MODE))
+#define PLAYER_CACHE_COUNTS         (PLAYER_CACHE_BIT(PLAYER_GET_QNT_USB_FILES) | PLAYER_CACHE_BIT(PLAYER_GET_QNT_TF_FILES) \
+                                    | PLAYER_CACHE_BIT(PLAYER_GET_QNT_FLASH_FILES) | PLAYER_CACHE_BIT(PLAYER_GET_QNT_FOLDER_FILES) \
+                                    | PLAYER_CACHE_BIT(PLAYER_GET_QNT_FOLDERS))
+#define PLAYER_CACHE_ALL            (PLAYER_CACHE_SETTINGS | PLAYER_CACHE_COUNTS | PLAYER_CACHE_BIT(PLAYER_GET_VERSION))
+
+/* Command classes with separate pacing */
+enum player_pace_class {
+  PLAYER_PACE_PLAYBACK,
+  PLAYER_PACE_SETTING,
+  PLAYER_PACE_QUERY,
+  PLAYER_PACE_SYSTEM,
+  PLAYER_PACE_CLASSES
+};
+
+/* Learned pacing of command class, msec */
+struct player_pace {
+  uint16_t reply;   // TX -> ACK/response latency estimate
+  uint16_t gap;     // extra spacing, grows back on busy/frame errors
+  uint8_t samples;
+};
+
+/* Module notifications */
+enum player_event_type {
+  PLAYER_EVENT_ONLINE,    // module ready, value = source mask
+  PLAYER_EVENT_INSERTED,  // value = source mask
+  PLAYER_EVENT_REMOVED,   // value = source mask
+  PLAYER_EVENT_DONE,      // track finished, value = track
+  PLAYER_EVENT_ADVERT_DONE, // advert clip finished, main track resumes, value = clip, 0 = not played
+};
+
+struct player_event {
+  uint8_t type;
+  uint16_t value;
+};
+
+/* Command queue lanes, user lane always goes first */
+enum player_lane {
+  PLAYER_LANE_USER,       // buttons, encoder, error recovery
+  PLAYER_LANE_BACKGROUND, // queries: scans, reconciliation, polls
+  PLAYER_LANES
+};
+
+/* Queue -> reply latency of lane, msec */
+struct player_lane_stats {
+  uint16_t count;
+  uint16_t average;   // moving average, 1/8 weight of new sample
+  uint16_t max;
+};
+
+/* Queued command */
+struct player_command {
+  uint8_t cmd;
+  uint8_t dh;
+  uint8_t dl;
+  uint8_t lane;
+  uint16_t queued;    // msec, low bits of scheduler_millis()
+};
+
 /* Callback */
 enum player_callback {
   PLAYER_CALLBACK_UNDEFINED,
@@ -90,6 +227,7 @@ void player_playTrack(uint16_t track);
 void player_volumeUp();
 void player_volumeDown();
 void player_setVolume(uint8_t volume);
+void player_setLevel(uint8_t volume);
 void player_setEqualizer(uint8_t preset);
 void player_repeatTrack(uint16_t track);
 void player_setSource(uint8_t source);
@@ -110,7 +248,19 @@ void player_repeatFolder(uint8_t folder);
 void player_randomAll();
 void player_repeatCurrentTrack(uint8_t repeat);
 void player_enableDac(uint8_t enable);
-void player_return();
+uint8_t player_errorClass(uint16_t code);
+void player_return(uint8_t *frame);
+void player_received();
+void player_task();
+uint8_t player_idle();
+uint8_t player_queued(uint8_t cmd);
+void player_query(uint8_t cmd, uint8_t param);
+void player_event(uint8_t type, uint16_t value);
+uint8_t player_getEvent(struct player_event *event);
+uint8_t player_answered(uint8_t cmd);
+uint8_t player_get(uint8_t cmd, uint8_t param, uint16_t *value);
+void player_invalidate(uint16_t mask);
+void player_report();
 
 #ifdef __cplusplus
 }
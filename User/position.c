@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "player.h"
+#include "scheduler.h"
+#include "position.h"
+
+extern uint8_t pFolder;
+extern uint16_t pTrack;
+extern uint8_t pState;
+extern uint8_t pAdvert;
+
+uint16_t posElapsed = 0;  // seconds played of current track, bound to progress bar
+uint16_t posDuration = 0; // seconds, 0 = not in duration table
+uint32_t posPlayed = 0;   // msec played before last resume
+uint32_t posSince = 0;    // msec of last resume
+uint16_t posKey = 0;
+uint8_t posState = PLAYER_STATE_STOPPED;
+
+/**
+ * @brief Find duration of track
+ * NOTE:
+ *  - binary search over sorted (folder << 8 | track) keys
+ *
+ * @return seconds, 0 = unknown
+ */
+uint16_t position_duration(uint8_t folder, uint16_t track) {
+  uint16_t key = ((uint16_t) folder << 8) | (track & 0xFF);
+  uint16_t low = 0;
+  uint16_t high = durationCount;
+
+  if (track > 0xFF) {
+    return 0;
+  }
+
+  while (low < high) {
+    uint16_t mid = (low + high) / 2;
+    if (durationKeys[mid] < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  if (low == durationCount || durationKeys[low] != key) {
+    return 0;
+  }
+  return durationSeconds[low];
+}
+
+/**
+ * @brief Track finished, module starts next one by itself in loop modes
+ */
+void position_done() {
+  posPlayed = 0;
+  posSince = scheduler_millis();
+  posElapsed = 0;
+}
+
+/**
+ * @brief Follow playback state & advance elapsed time, call from player task
+ * NOTE:
+ *  - no module queries, time is counted from play/pause/stop & track changes
+ *  - elapsed time stops at track duration, e.g. until DONE arrives
+ *  - advert clip holds main track, time is not counted meanwhile
+ */
+void position_task() {
+  uint16_t key = ((uint16_t) pFolder << 8) | pTrack;
+  uint32_t now = scheduler_millis();
+  uint32_t played;
+  uint8_t state = pState;
+
+  if (pAdvert && state == PLAYER_STATE_PLAYING) {
+    state = PLAYER_STATE_PAUSED; // main track is held while advert clip plays
+  }
+
+  if (key != posKey) {
+    posKey = key;
+    posDuration = position_duration(pFolder, pTrack);
+    posPlayed = 0;
+    posSince = now;
+  }
+
+  if (state != posState) {
+    if (posState == PLAYER_STATE_PLAYING) {
+      posPlayed += now - posSince;
+    }
+    if (state == PLAYER_STATE_STOPPED) {
+      posPlayed = 0;
+    }
+    posSince = now;
+    posState = state;
+  }
+
+  played = posPlayed;
+  if (posState == PLAYER_STATE_PLAYING) {
+    played += now - posSince;
+  }
+  posElapsed = played / 1000;
+  if (posDuration > 0 && posElapsed > posDuration) {
+    posElapsed = posDuration;
+  }
+}
@@ -0,0 +1,25 @@
+#ifndef _POSITION_H
+#define _POSITION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef POSITION_ENABLE
+#define POSITION_ENABLE 0 // 1 = progress bar from local clock & track lengths of Tools/durationgen.py
+#endif
+
+/* Generated tables, see Tools/durationgen.py */
+extern const uint16_t durationCount;
+extern const uint16_t durationKeys[];
+extern const uint16_t durationSeconds[];
+
+uint16_t position_duration(uint8_t folder, uint16_t track);
+void position_done();
+void position_task();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
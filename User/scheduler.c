@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "debug.h"
+#include "scheduler.h"
+
+/* SysTick control bits */
+#define SYSTICK_CTLR_STE    (1 << 0) // Counter enable
+#define SYSTICK_CTLR_STIE   (1 << 1) // Compare interrupt enable
+#define SYSTICK_CTLR_STCLK  (1 << 2) // Clock source, 1 = HCLK, 0 = HCLK/8
+#define SYSTICK_SR_CNTIF    (1 << 0) // Compare flag
+
+struct scheduler_entry {
+  void (*run)();
+  uint16_t period;
+  uint32_t next;
+};
+
+struct scheduler_entry sTasks[SCHEDULER_TASKS];
+struct scheduler_load sLoad;    // last finished window, read by diagnostics
+struct scheduler_load sCurrent; // window in progress
+
+volatile uint32_t sMillis = 0;
+volatile uint32_t sIsrCycles = 0; // running sum of all ISR cycles
+uint32_t sCyclesPerTick = 0;
+uint32_t sWindowStart = 0;
+uint32_t sWindowMillis = 0;
+
+/**
+ * @brief Start SysTick as free running HCLK cycle counter with 1 msec compare interrupt
+ * NOTE:
+ *  - Delay_Ms()/Delay_Us() reprogram SysTick, use scheduler_delay() after this call
+ */
+void scheduler_init() {
+  sCyclesPerTick = SystemCoreClock / SCHEDULER_TICK_HZ;
+
+  SysTick->CTLR = 0;
+  SysTick->SR = 0;
+  SysTick->CNT = 0;
+  SysTick->CMP = sCyclesPerTick;
+
+  NVIC_SetPriority(SysTicK_IRQn, 0xF0);
+  NVIC_EnableIRQ(SysTicK_IRQn);
+
+  SysTick->CTLR = SYSTICK_CTLR_STE | SYSTICK_CTLR_STIE | SYSTICK_CTLR_STCLK;
+}
+
+/**
+ * @brief Register task
+ * NOTE:
+ *  - period in msec, 0 = run on every scheduler pass
+ */
+void scheduler_add(enum scheduler_task task, void (*run)(), uint16_t period) {
+  sTasks[task].run = run;
+  sTasks[task].period = period;
+  sTasks[task].next = sMillis;
+}
+
+/**
+ * @brief Milliseconds since scheduler_init()
+ */
+uint32_t scheduler_millis() {
+  return sMillis;
+}
+
+/**
+ * @brief HCLK cycles, wraps every 2^32 cycles (~89 sec at 48 MHz)
+ */
+uint32_t scheduler_cycles() {
+  return SysTick->CNT;
+}
+
+/**
+ * @brief Busy wait, replacement for Delay_Ms()
+ */
+void scheduler_delay(uint32_t ms) {
+  uint32_t start = sMillis;
+  while (sMillis - start < ms) {
+    /* waiting for ticks */
+  }
+}
+
+/**
+ * @brief Account ISR cycles, called on ISR exit via SCHEDULER_ISR_EXIT()
+ * NOTE:
+ *  - USART1 preempts TIM1 & SysTick, cycles of nested ISR are counted for nested ISR only
+ */
+void scheduler_isrDone(enum scheduler_isr isr, uint32_t start, uint32_t nested) {
+  uint32_t cycles = (scheduler_cycles() - start) - (sIsrCycles - nested);
+  sCurrent.isr[isr] += cycles;
+  sIsrCycles += cycles;
+}
+
+/**
+ * @brief Share of cycles in last window, 0..1000
+ */
+uint16_t scheduler_permille(uint32_t cycles) {
+  uint32_t scale = sLoad.total / 1000;
+  if (scale == 0) {
+    return 0;
+  }
+  return cycles / scale;
+}
+
+/**
+ * @brief Close accounting window, everything not spent in tasks or ISRs is idle
+ */
+void scheduler_snapshot() {
+  uint32_t now = scheduler_cycles();
+
+  __disable_irq();
+  sLoad = sCurrent;
+  for (uint8_t i = 0; i < SCHEDULER_ISRS; i++) {
+    sCurrent.isr[i] = 0;
+  }
+  __enable_irq();
+
+  for (uint8_t i = 0; i < SCHEDULER_TASKS; i++) {
+    sCurrent.task[i] = 0;
+  }
+
+  sLoad.total = now - sWindowStart;
+  sLoad.idle = sLoad.total;
+  for (uint8_t i = 0; i < SCHEDULER_TASKS; i++) {
+    sLoad.idle -= sLoad.task[i];
+  }
+  for (uint8_t i = 0; i < SCHEDULER_ISRS; i++) {
+    sLoad.idle -= sLoad.isr[i];
+  }
+  sWindowStart = now;
+
+#if (SCHEDULER_STATS_PRINT == 1)
+  printf("Load idle: %u, player: %u, display: %u, input: %u, usart1: %u, tim: %u, systick: %u\r\n",
+    scheduler_permille(sLoad.idle),
+    scheduler_permille(sLoad.task[SCHEDULER_TASK_PLAYER]),
+    scheduler_permille(sLoad.task[SCHEDULER_TASK_DISPLAY]),
+    scheduler_permille(sLoad.task[SCHEDULER_TASK_INPUT]),
+    scheduler_permille(sLoad.isr[SCHEDULER_ISR_USART1]),
+    scheduler_permille(sLoad.isr[SCHEDULER_ISR_TIM]),
+    scheduler_permille(sLoad.isr[SCHEDULER_ISR_SYSTICK]));
+#endif
+}
+
+/**
+ * @brief Run tasks forever
+ * NOTE:
+ *  - load values are permille (0..1000) of the window
+ */
+void scheduler_run() {
+  sWindowStart = scheduler_cycles();
+  sWindowMillis = sMillis;
+
+  while (1) {
+    for (uint8_t i = 0; i < SCHEDULER_TASKS; i++) {
+      struct scheduler_entry *task = &sTasks[i];
+      if (task->run == 0 || (int32_t) (sMillis - task->next) < 0) {
+        continue;
+      }
+      task->next += task->period;
+      if ((int32_t) (sMillis - task->next) > 0) {
+        task->next = sMillis; // overrun, don't try to catch up
+      }
+
+#if (SCHEDULER_LOAD_ENABLE == 1)
+      uint32_t isrBefore = sIsrCycles;
+      uint32_t start = scheduler_cycles();
+      task->run();
+      sCurrent.task[i] += (scheduler_cycles() - start) - (sIsrCycles - isrBefore);
+#else
+      task->run();
+#endif
+    }
+
+#if (SCHEDULER_LOAD_ENABLE == 1)
+    if (sMillis - sWindowMillis >= SCHEDULER_STATS_PERIOD) {
+      sWindowMillis += SCHEDULER_STATS_PERIOD;
+      scheduler_snapshot();
+    }
+#endif
+  }
+}
+
+/**
+ * @fn      SysTick_Handler
+ * @brief   Millisecond tick, compare value moves forward so the counter keeps running
+ */
+void SysTick_Handler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void SysTick_Handler(void) {
+  SCHEDULER_ISR_ENTER();
+
+  SysTick->SR &= ~SYSTICK_SR_CNTIF;
+  SysTick->CMP += sCyclesPerTick;
+  sMillis++;
+
+  SCHEDULER_ISR_EXIT(SCHEDULER_ISR_SYSTICK);
+}
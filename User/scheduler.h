@@ -0,0 +1,67 @@
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCHEDULER_TICK_HZ       1000 // SysTick interrupt rate, 1 tick = 1 msec
+#define SCHEDULER_STATS_PERIOD  1000 // Load accounting window, msec
+
+#ifndef SCHEDULER_LOAD_ENABLE
+#define SCHEDULER_LOAD_ENABLE   0    // 1 = per task & ISR load accounting, diagnostics page & reports on long press of PREV
+#endif
+
+#ifndef SCHEDULER_STATS_PRINT
+#define SCHEDULER_STATS_PRINT   1    // 1 = print load snapshot to debug channel every window, 0 = silent
+#endif
+
+/* Cooperative tasks, run from scheduler_run() */
+enum scheduler_task {
+  SCHEDULER_TASK_PLAYER,
+  SCHEDULER_TASK_DISPLAY,
+  SCHEDULER_TASK_INPUT,
+  SCHEDULER_TASKS
+};
+
+/* Interrupt sources with load accounting */
+enum scheduler_isr {
+  SCHEDULER_ISR_USART1,
+  SCHEDULER_ISR_TIM,
+  SCHEDULER_ISR_SYSTICK,
+  SCHEDULER_ISRS
+};
+
+/* Cycles spent in every context during one accounting window */
+struct scheduler_load {
+  uint32_t total;
+  uint32_t idle;
+  uint32_t task[SCHEDULER_TASKS];
+  uint32_t isr[SCHEDULER_ISRS];
+};
+
+/* Measure ISR body, ISR time is excluded from the task or ISR it has interrupted */
+#if (SCHEDULER_LOAD_ENABLE == 1)
+#define SCHEDULER_ISR_ENTER()   uint32_t isrStart = scheduler_cycles(), isrNested = sIsrCycles
+#define SCHEDULER_ISR_EXIT(isr) scheduler_isrDone(isr, isrStart, isrNested)
+#else
+#define SCHEDULER_ISR_ENTER()
+#define SCHEDULER_ISR_EXIT(isr)
+#endif
+
+extern volatile uint32_t sIsrCycles;
+
+void scheduler_init();
+void scheduler_add(enum scheduler_task task, void (*run)(), uint16_t period);
+void scheduler_run();
+void scheduler_delay(uint32_t ms);
+uint32_t scheduler_millis();
+uint32_t scheduler_cycles();
+void scheduler_isrDone(enum scheduler_isr isr, uint32_t start, uint32_t nested);
+uint16_t scheduler_permille(uint32_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
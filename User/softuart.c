@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "debug.h"
+#include "scheduler.h"
+#include "softuart.h"
+
+#if (SDI_PRINT == SDI_PR_SOFT)
+
+uint8_t suBuffer[SOFTUART_BUFFER_SIZE];
+volatile uint8_t suHead = 0;
+volatile uint8_t suTail = 0;
+volatile uint8_t suBit = 0;   // 0 = idle, 1 = start pending, 2..9 = data bits, 10 = stop bit, 11 = stop bit sent
+uint8_t suByte = 0;           // byte being shifted out
+
+/**
+ * @brief Setup debug TX pin & TIM1 bit clock
+ * NOTE:
+ *  - timer runs only while there is something to send
+ */
+void softuart_init() {
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC | RCC_APB2Periph_TIM1, ENABLE);
+
+  GPIO_InitTypeDef initTx = {0};
+  initTx.GPIO_Pin = SOFTUART_PIN;
+  initTx.GPIO_Mode = GPIO_Mode_Out_PP;
+  initTx.GPIO_Speed = GPIO_Speed_30MHz;
+  GPIO_Init(SOFTUART_PORT, &initTx);
+  GPIO_SetBits(SOFTUART_PORT, SOFTUART_PIN); // line idle high
+
+  TIM_TimeBaseInitTypeDef initBase = {0};
+  initBase.TIM_Period = SystemCoreClock / SOFTUART_BAUD - 1;
+  initBase.TIM_Prescaler = 0;
+  initBase.TIM_ClockDivision = TIM_CKD_DIV1;
+  initBase.TIM_CounterMode = TIM_CounterMode_Up;
+  TIM_TimeBaseInit(TIM1, &initBase);
+  TIM_ClearITPendingBit(TIM1, TIM_IT_Update);
+  TIM_ITConfig(TIM1, TIM_IT_Update, ENABLE);
+
+  // lowest priority, a late bit only stretches it a little, player RX must not wait
+  NVIC_InitTypeDef initNvic = {0};
+  initNvic.NVIC_IRQChannel = TIM1_UP_IRQn;
+  initNvic.NVIC_IRQChannelPreemptionPriority = 1;
+  initNvic.NVIC_IRQChannelSubPriority = 1;
+  initNvic.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&initNvic);
+}
+
+/**
+ * @brief Start bit clock if bytes are waiting & line is idle
+ */
+void softuart_start() {
+  if (suBit == 0 && suTail != suHead) {
+    suBit = 1;
+    TIM_SetCounter(TIM1, 0);
+    TIM_Cmd(TIM1, ENABLE);
+  }
+}
+
+/**
+ * @brief Queue bytes for transmit, called from printf via _write()
+ * NOTE:
+ *  - returns at once while line fits in buffer, burst of lines waits for space, 260 usec per byte
+ *  - never call from interrupt, TIM1 interrupt has lowest priority & would never free space
+ *
+ * @return size
+ */
+int softuart_write(char *buf, int size) {
+  for (int i = 0; i < size; i++) {
+    uint8_t next = (suHead + 1) % SOFTUART_BUFFER_SIZE;
+    while (next == suTail) {
+      softuart_start(); // waiting for transmit
+    }
+    suBuffer[suHead] = buf[i];
+    suHead = next;
+  }
+
+  softuart_start();
+  return size;
+}
+
+/**
+ * @fn      TIM1_UP_IRQHandler
+ * @brief   Shift out one bit per timer update
+ */
+void TIM1_UP_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void TIM1_UP_IRQHandler(void) {
+  SCHEDULER_ISR_ENTER();
+  TIM_ClearITPendingBit(TIM1, TIM_IT_Update);
+
+  if (suBit >= 2 && suBit <= 9) {
+    if (suByte & 1) {
+      SOFTUART_PORT->BSHR = SOFTUART_PIN;
+    } else {
+      SOFTUART_PORT->BCR = SOFTUART_PIN;
+    }
+    suByte >>= 1;
+    suBit++;
+  } else if (suBit == 10) {
+    SOFTUART_PORT->BSHR = SOFTUART_PIN;
+    suTail = (suTail + 1) % SOFTUART_BUFFER_SIZE;
+    suBit++;
+  } else if (suTail != suHead) {
+    // start bit of next byte right after stop bit
+    suByte = suBuffer[suTail];
+    SOFTUART_PORT->BCR = SOFTUART_PIN;
+    suBit = 2;
+  } else {
+    suBit = 0;
+    TIM_Cmd(TIM1, DISABLE);
+  }
+
+  SCHEDULER_ISR_EXIT(SCHEDULER_ISR_TIM);
+}
+
+#endif
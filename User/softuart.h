@@ -0,0 +1,20 @@
+#ifndef _SOFTUART_H
+#define _SOFTUART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SOFTUART_BAUD         38400 // Debug output baud rate, one TIM1 interrupt per bit
+#define SOFTUART_BUFFER_SIZE  128   // Bytes waiting for transmit, longest line fits, writer waits when full
+#define SOFTUART_PORT         GPIOC
+#define SOFTUART_PIN          GPIO_Pin_0 // TX --> C.0, spare pin, USART1 D.5/D.6 belongs to player
+
+void softuart_init();
+int softuart_write(char *buf, int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
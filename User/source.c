@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <ch32v00x.h>
+#include "debug.h"
+#include "player.h"
+#include "scheduler.h"
+#include "library.h"
+#include "source.h"
+
+extern uint8_t pSource;
+extern uint8_t pDevice;
+extern uint8_t pFolder;
+extern uint16_t pTrack;
+extern uint16_t pVolume;
+extern uint8_t pState;
+
+const uint8_t sMasks[SOURCE_COUNT] = {PLAYER_SOURCE_TF, PLAYER_SOURCE_USB, PLAYER_SOURCE_FLASH};
+
+uint8_t sActive = SOURCE_NONE;      // storage playing from
+uint8_t sTarget = SOURCE_NONE;      // storage being switched to
+uint8_t sState = SOURCE_IDLE;
+uint8_t sResume = 0;                // playback was running when switch started
+uint8_t sChanged = 0;               // switch done, UI shows other storage
+uint32_t sStart = 0;                // msec switch started
+uint32_t sChecked = 0;              // msec status query was sent
+struct source_slot sSlots[SOURCE_COUNT];
+struct library_bank sBank;          // index cache of sBankSource
+uint8_t sBankSource = SOURCE_NONE;
+uint16_t sCount = 0;                // switches done
+uint16_t sAverage = 0;              // switch start to storage ready, msec
+uint16_t sMax = 0;
+
+/**
+ * @brief PLAYER_SET_SOURCE value of storage
+ * NOTE:
+ *  - NOR flash is 4 on GD3200B, but variant is only guessed from reply time & 4 puts YX5200 to sleep,
+ *    documented 5 is used unless SOURCE_FLASH_DEVICE says otherwise
+ */
+uint8_t source_device(uint8_t id) {
+  switch (id) {
+    case SOURCE_USB:
+      return 1;
+    case SOURCE_TF:
+      return 2;
+    default:
+      return SOURCE_FLASH_DEVICE;
+  }
+}
+
+/**
+ * @brief First storage in switch order found in source mask
+ *
+ * @return storage, SOURCE_NONE = mask empty
+ */
+uint8_t source_pick(uint8_t mask) {
+  for (uint8_t id = 0; id < SOURCE_COUNT; id++) {
+    if (mask & sMasks[id]) {
+      return id;
+    }
+  }
+  return SOURCE_NONE;
+}
+
+/**
+ * @brief Switch to storage, playback state of storage left is kept
+ * NOTE:
+ *  - only PLAYER_SET_SOURCE is sent now, rest follows when module reports storage ready
+ *  - index cache of storage left is kept aside, one storage at a time
+ *
+ * @return 1 = switch started
+ */
+uint8_t source_select(uint8_t id) {
+  if (id >= SOURCE_COUNT || id == sActive || sState != SOURCE_IDLE || !(pSource & sMasks[id])) {
+    return 0;
+  }
+
+  if (sActive != SOURCE_NONE) {
+    sSlots[sActive].valid = 1;
+    sSlots[sActive].folder = pFolder;
+    sSlots[sActive].track = pTrack;
+    sSlots[sActive].volume = pVolume;
+    library_save(&sBank);
+    sBankSource = sActive;
+  }
+  sResume = (pState == PLAYER_STATE_PLAYING);
+
+  printf("Source: %u -> %u\r\n", sActive, id);
+  sTarget = id;
+  sState = SOURCE_SWITCHING;
+  sStart = scheduler_millis();
+  player_setSource(source_device(id));
+  return 1;
+}
+
+/**
+ * @brief Switch to next storage online, in enum source_id order
+ *
+ * @return 1 = switch started
+ */
+uint8_t source_next() {
+  uint8_t id = sActive;
+
+  for (uint8_t i = 1; i < SOURCE_COUNT; i++) {
+    id = (id + 1 < SOURCE_COUNT) ? id + 1 : 0;
+    if (pSource & sMasks[id]) {
+      return source_select(id);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Storage selected is ready, restore its state with as few commands as possible
+ * NOTE:
+ *  - volume is sent only if it differs, track only if playback was running
+ *  - module has no seek, track starts from the beginning
+ */
+void source_ready(const char *how) {
+  struct source_slot *slot = &sSlots[sTarget];
+  uint16_t latency = scheduler_millis() - sStart;
+
+  sAverage = (sCount == 0) ? latency : sAverage + ((int16_t) (latency - sAverage)) / 8;
+  if (latency > sMax) {
+    sMax = latency;
+  }
+  sCount++;
+  printf("Source: %u ready in %u ms by %s\r\n", sTarget, latency, how);
+
+  sActive = sTarget;
+  sState = SOURCE_IDLE;
+  sChanged = 1;
+
+  if (sBankSource == sActive) {
+    library_restore(&sBank);
+    sBankSource = SOURCE_NONE;
+  } else {
+    library_invalidate();
+  }
+
+  if (!slot->valid) {
+    slot->valid = 1;
+    slot->folder = 1;
+    slot->track = 1;
+    slot->volume = pVolume;
+  }
+  if (slot->volume != pVolume) {
+    player_setVolume(slot->volume);
+  }
+  if (sResume) {
+    player_playFolder(slot->folder, slot->track);
+  } else {
+    pFolder = slot->folder;
+    pTrack = slot->track;
+  }
+}
+
+/**
+ * @brief Module reported storages online, call on PLAYER_EVENT_ONLINE
+ * NOTE:
+ *  - READY during switch ends it, otherwise module rebooted & picked storage by itself
+ *
+ * @return 1 = event was end of switch, nothing else to do
+ */
+uint8_t source_online(uint8_t mask) {
+  if (sState != SOURCE_IDLE) {
+    source_ready("ready");
+    return 1;
+  }
+  sActive = source_pick(mask);
+  pDevice = 0;
+  return 0;
+}
+
+/**
+ * @brief Storage inserted, call on PLAYER_EVENT_INSERTED
+ * NOTE:
+ *  - state kept for storage is dropped, medium may be other one
+ */
+void source_inserted(uint8_t mask) {
+  uint8_t id = source_pick(mask);
+
+  if (id == SOURCE_NONE) {
+    return;
+  }
+  sSlots[id].valid = 0;
+  if (sBankSource == id) {
+    sBankSource = SOURCE_NONE;
+  }
+  if (sActive == SOURCE_NONE) {
+    sActive = id;
+  }
+}
+
+/**
+ * @brief Storage removed, call on PLAYER_EVENT_REMOVED
+ *
+ * @return 1 = playing storage is gone & other one is being selected
+ */
+uint8_t source_removed(uint8_t mask) {
+  for (uint8_t id = 0; id < SOURCE_COUNT; id++) {
+    if (mask & sMasks[id] && sBankSource == id) {
+      sBankSource = SOURCE_NONE;
+    }
+  }
+  if (sActive == SOURCE_NONE || !(mask & sMasks[sActive])) {
+    return 0;
+  }
+  sActive = SOURCE_NONE;
+  return source_select(source_pick(pSource));
+}
+
+/**
+ * @brief Check switch finished since last call, e.g. to redraw lists
+ */
+uint8_t source_changed() {
+  uint8_t changed = sChanged;
+
+  sChanged = 0;
+  return changed;
+}
+
+/**
+ * @brief Watch switch, call from player task
+ * NOTE:
+ *  - modules without READY after PLAYER_SET_SOURCE are asked for status after SOURCE_READY_TIMEOUT
+ */
+void source_task() {
+  uint32_t now = scheduler_millis();
+
+  switch (sState) {
+    case SOURCE_SWITCHING:
+      if (now - sStart < SOURCE_READY_TIMEOUT) {
+        break;
+      }
+      sState = SOURCE_CHECKING;
+      sChecked = now;
+      player_query(PLAYER_GET_STATUS, 0);
+      break;
+
+    case SOURCE_CHECKING:
+      if (player_answered(PLAYER_GET_STATUS)) {
+        source_ready("status");
+      } else if (now - sChecked >= SOURCE_STATUS_TIMEOUT) {
+        source_ready("timeout");
+      }
+      break;
+  }
+}
+
+/**
+ * @brief Print switch time to debug channel
+ */
+void source_report() {
+  printf("Source %u, switches: %u avg %u max %u ms\r\n", sActive, sCount, sAverage, sMax);
+}
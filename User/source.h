@@ -0,0 +1,57 @@
+#ifndef _SOURCE_H
+#define _SOURCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SOURCE_ENABLE
+#define SOURCE_ENABLE         0     // 1 = playback state kept per storage, long press of PREV in browser switches storage, needs BROWSER_ENABLE 1
+#endif
+
+#define SOURCE_COUNT          3     // Storages with own state, enum source_id
+#define SOURCE_READY_TIMEOUT  1500  // No READY after switch, module is asked for status, msec
+#define SOURCE_STATUS_TIMEOUT 1000  // No status answer either, switch is taken as done, msec
+
+#ifndef SOURCE_FLASH_DEVICE
+#define SOURCE_FLASH_DEVICE   5     // PLAYER_SET_SOURCE value of NOR flash, set 4 only for board known to be GD3200B
+#endif
+
+/* Storages, order is switch order */
+enum source_id {
+  SOURCE_TF,
+  SOURCE_USB,
+  SOURCE_FLASH,
+  SOURCE_NONE = 0xFF,
+};
+
+/* Switch steps */
+enum source_state {
+  SOURCE_IDLE,
+  SOURCE_SWITCHING, // PLAYER_SET_SOURCE sent, waiting for READY
+  SOURCE_CHECKING,  // no READY, status query sent
+};
+
+/* Playback state kept per storage while other one plays */
+struct source_slot {
+  uint8_t valid;
+  uint8_t folder;
+  uint16_t track;
+  uint8_t volume;
+  uint8_t playing;
+};
+
+uint8_t source_select(uint8_t id);
+uint8_t source_next();
+uint8_t source_online(uint8_t mask);
+void source_inserted(uint8_t mask);
+uint8_t source_removed(uint8_t mask);
+uint8_t source_changed();
+void source_task();
+void source_report();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
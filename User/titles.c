@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include "fonts.h"
+#include "titles.h"
+
+/**
+ * @brief Find title of track
+ * NOTE:
+ *  - binary search over sorted (folder << 8 | track) keys
+ *
+ * @return 1 = found & reader points to first symbol, 0 = no title
+ */
+uint8_t title_find(uint8_t folder, uint16_t track, struct title_reader *reader) {
+  uint16_t key = ((uint16_t) folder << 8) | (track & 0xFF);
+  uint16_t low = 0;
+  uint16_t high = titleCount;
+
+  if (track > 0xFF) {
+    return 0;
+  }
+
+  while (low < high) {
+    uint16_t mid = (low + high) / 2;
+    if (titleKeys[mid] < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  if (low == titleCount || titleKeys[low] != key) {
+    return 0;
+  }
+
+  reader->data = &titleData[titleOffsets[low]];
+  reader->mask = 0x80;
+  return 1;
+}
+
+/**
+ * @brief Decode next byte of title
+ * NOTE:
+ *  - canonical Huffman, code bits are read MSB first straight from flash
+ *
+ * @return byte, 0 = end of title
+ */
+char title_next(struct title_reader *reader) {
+  uint16_t code = 0;
+  uint16_t first = 0;
+  uint16_t index = 0;
+
+  for (uint8_t len = 0; len < TITLE_MAX_BITS; len++) {
+    code |= (*reader->data & reader->mask) ? 1 : 0;
+    reader->mask >>= 1;
+    if (reader->mask == 0) {
+      reader->mask = 0x80;
+      reader->data++;
+    }
+
+    uint8_t count = titleLengths[len];
+    if (code - first < count) {
+      return titleSymbols[index + code - first];
+    }
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  }
+
+  return 0; // broken table
+}
+
+/**
+ * @brief Decode next code point of title, UTF-8 bytes are joined
+ *
+ * @return code point, 0 = end of title
+ */
+uint16_t title_nextCode(struct title_reader *reader) {
+  struct utf8_decoder decoder = { 0, 0 };
+  uint16_t code;
+  char c;
+
+  while ((c = title_next(reader)) != 0) {
+    if (utf8_feed(&decoder, c, &code)) {
+      return code;
+    }
+  }
+  return decoder.pending ? FONT_REPLACEMENT : 0;
+}
+
+/**
+ * @brief Render title as proportional text, marquee source
+ *
+ * @param title struct title_reader at start of title, not modified
+ * @param skip columns to skip
+ * @return used columns
+ */
+uint8_t title_render(const void *title, uint16_t skip, uint8_t *buffer, uint8_t size) {
+  struct title_reader reader = *(const struct title_reader *) title;
+  uint8_t x = 0;
+  uint16_t code;
+
+  while (x < size && (code = title_nextCode(&reader)) != 0) {
+    x += charProp(code, &skip, buffer + x, size - x);
+  }
+  return x;
+}
+
+/**
+ * @brief Width of title in columns
+ */
+uint16_t title_width(const struct title_reader *title) {
+  struct title_reader reader = *title;
+  uint16_t width = 0;
+  uint16_t code;
+
+  while ((code = title_nextCode(&reader)) != 0) {
+    width += charPropWidth(code);
+  }
+  return width;
+}
@@ -0,0 +1,34 @@
+#ifndef _TITLES_H
+#define _TITLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TITLE_MAX_BITS  15 // Longest Huffman code, same as MAX_BITS in Tools/titlegen.py
+
+/* Generated tables, see Tools/titlegen.py */
+extern const uint16_t titleCount;
+extern const uint8_t titleLengths[TITLE_MAX_BITS];
+extern const uint8_t titleSymbols[];
+extern const uint16_t titleKeys[];
+extern const uint16_t titleOffsets[];
+extern const uint8_t titleData[];
+
+/* Decoder position inside titleData */
+struct title_reader {
+  const uint8_t *data;
+  uint8_t mask;
+};
+
+uint8_t title_find(uint8_t folder, uint16_t track, struct title_reader *reader);
+char title_next(struct title_reader *reader);
+uint16_t title_nextCode(struct title_reader *reader);
+uint8_t title_render(const void *title, uint16_t skip, uint8_t *buffer, uint8_t size);
+uint16_t title_width(const struct title_reader *title);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+/*
+   Generated by Tools/titlegen.py, DON'T EDIT
+   Source: Tools/titles.txt, 10 titles, 180 bytes raw, 115 bytes coded
+*/
+
+#include <stdio.h>
+#include "titles.h"
+
+const uint16_t titleCount = 10;
+
+const uint8_t titleLengths[TITLE_MAX_BITS] = { 0, 0, 1, 6, 6, 7, 26, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+const uint8_t titleSymbols[46] = {
+  0x20, 0x00, 0x61, 0x65, 0x6F, 0x72, 0xD0, 0x68, 0x69, 0x6C, 0x6E, 0x74, 0x77, 0x2D, 0x50, 0x52,
+  0x53, 0x54, 0x64, 0x67, 0x41, 0x43, 0x45, 0x49, 0x4D, 0x4F, 0x57, 0x66, 0x6B, 0x6D, 0x73, 0x75,
+  0x76, 0x91, 0x97, 0xA9, 0xB1, 0xB2, 0xB4, 0xB5, 0xB7, 0xBC, 0xBD, 0xBE, 0xC3, 0xD1,
+};
+
+const uint16_t titleKeys[10] = {
+  0x0101, 0x0102, 0x0103, 0x0201, 0x0202, 0x0203, 0x0204, 0x0205, 0x0301, 0x0302,
+};
+
+const uint16_t titleOffsets[10] = {
+  0, 4, 13, 22, 35, 48, 62, 78, 87, 105,
+};
+
+const uint8_t titleData[115] = {
+  0xD3, 0x3A, 0x32, 0x90, 0xD4, 0xAD, 0x38, 0xCF, 0x21, 0xB0, 0xE5, 0xB8, 0x80, 0xD1, 0xC9, 0x27,
+  0x19, 0xE4, 0x36, 0x1C, 0xB7, 0x10, 0xB8, 0xF1, 0x8A, 0x8B, 0xE0, 0xB5, 0x16, 0x0B, 0x4D, 0xA8,
+  0x35, 0xCD, 0x08, 0xB8, 0xF1, 0x8A, 0x8B, 0xE0, 0xB5, 0x16, 0x0B, 0x4D, 0xA8, 0x30, 0xAA, 0x90,
+  0xB8, 0xF1, 0x8A, 0x8B, 0xE0, 0xB5, 0x16, 0x0B, 0x4D, 0xA8, 0x30, 0x83, 0x22, 0x10, 0xD3, 0x3A,
+  0x23, 0x72, 0x8A, 0x54, 0x56, 0x34, 0x80, 0xA4, 0x10, 0x66, 0xE3, 0x48, 0x2B, 0x10, 0xCF, 0x25,
+  0xE1, 0x19, 0xE4, 0x30, 0x82, 0x6F, 0x42, 0x7E, 0x8F, 0xDF, 0xFF, 0x37, 0xF4, 0xFE, 0x1F, 0xE3,
+  0xFD, 0x7F, 0x21, 0xFE, 0x3F, 0x97, 0xEC, 0xFF, 0x48, 0xCE, 0x7B, 0x7F, 0x75, 0x1A, 0xBF, 0x7B,
+  0x94, 0x91, 0x88,
+};
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <ch32v00x.h>
+#include "debug.h"
+#include "player.h"
+#include "scheduler.h"
+#include "variant.h"
+
+extern enum player_module pModule;
+extern struct player_pace pPace[PLAYER_PACE_CLASSES];
+extern uint8_t pFallback;
+extern uint8_t rxPos;
+
+uint8_t vState = VARIANT_UNKNOWN;
+uint32_t vSince = 0;
+uint8_t vSave = 0;              // record differs from flash, written when link is idle
+uint8_t vSaved = 0;             // written since boot, at most once
+struct variant_record vRecord;  // as stored in flash
+
+/**
+ * @brief Check word of record
+ */
+uint32_t variant_check(const struct variant_record *record) {
+  const uint32_t *word = (const uint32_t *) record;
+  uint32_t sum = 0;
+
+  for (uint8_t i = 0; i < offsetof(struct variant_record, check) / 4; i++) {
+    sum += word[i];
+  }
+  return ~sum;
+}
+
+/**
+ * @brief Load detected module & its learned pacing from flash, call before first command
+ * NOTE:
+ *  - pacing is trusted at once, no conservative start
+ *
+ * @return 1 = record valid, detection is skipped
+ */
+uint8_t variant_load() {
+  memcpy(&vRecord, (const void *) VARIANT_ADDRESS, sizeof(vRecord));
+  if (vRecord.magic != VARIANT_MAGIC || vRecord.check != variant_check(&vRecord)
+      || vRecord.module > PLAYER_NO_CHECKSUM) {
+    vRecord.magic = 0;
+    vState = VARIANT_UNKNOWN;
+    return 0;
+  }
+
+  pModule = vRecord.module;
+  for (uint8_t i = 0; i < PLAYER_PACE_CLASSES; i++) {
+    if (vRecord.reply[i] > 0) {
+      pPace[i].reply = vRecord.reply[i];
+      pPace[i].samples = PLAYER_PACE_SAMPLES;
+      pPace[i].gap = 0;
+    }
+  }
+  pFallback = 0;
+  vState = VARIANT_KNOWN;
+  printf("Variant: module %u from flash\r\n", pModule);
+  return 1;
+}
+
+/**
+ * @brief Write module & learned pacing to flash
+ * NOTE:
+ *  - fast page erase & program of 64 bytes, CPU stalls ~5 msec
+ */
+void variant_save() {
+  uint32_t page[16];
+
+  memset(page, 0xFF, sizeof(page));
+  vRecord.magic = VARIANT_MAGIC;
+  vRecord.module = pModule;
+  for (uint8_t i = 0; i < PLAYER_PACE_CLASSES; i++) {
+    vRecord.reply[i] = (pPace[i].samples >= PLAYER_PACE_SAMPLES) ? pPace[i].reply : 0;
+  }
+  vRecord.check = variant_check(&vRecord);
+  memcpy(page, &vRecord, sizeof(vRecord));
+
+  FLASH_Unlock_Fast();
+  FLASH_ErasePage_Fast(VARIANT_ADDRESS);
+  FLASH_BufReset();
+  for (uint8_t i = 0; i < 16; i++) {
+    FLASH_BufLoad(VARIANT_ADDRESS + i * 4, page[i]);
+  }
+  FLASH_ProgramPage_Fast(VARIANT_ADDRESS);
+  FLASH_Lock_Fast();
+
+  printf("Variant: module %u saved\r\n", pModule);
+}
+
+/**
+ * @brief Start detection once module is up, nothing to do if record was loaded
+ */
+void variant_start() {
+  if (vState == VARIANT_KNOWN) {
+    return;
+  }
+  player_query(PLAYER_GET_STATUS, 0);
+  vSince = scheduler_millis();
+  vState = VARIANT_PROBE;
+}
+
+/**
+ * @brief Detection step, call from boot sequence until it returns 1
+ * NOTE:
+ *  - YX5200/AAxxxx, FN6100 & GD3200B share checksum, only reply time tells GD3200B apart
+ *  - no answer with checksum, frame without checksum is tried before giving up
+ *
+ * @return 1 = done
+ */
+uint8_t variant_step() {
+  uint16_t reply;
+
+  if (vState != VARIANT_PROBE) {
+    return 1;
+  }
+
+  if (player_answered(PLAYER_GET_STATUS)) {
+    reply = pPace[PLAYER_PACE_QUERY].reply;
+    if (pModule != PLAYER_NO_CHECKSUM) {
+      pModule = (reply > VARIANT_SLOW_REPLY) ? PLAYER_HW_247A : PLAYER_MINI;
+    }
+    printf("Variant: status reply %u ms, module %u\r\n", reply, pModule);
+    vSave = (vRecord.magic != VARIANT_MAGIC || vRecord.module != pModule);
+    vState = VARIANT_KNOWN;
+    return 1;
+  }
+
+  if (scheduler_millis() - vSince < VARIANT_PROBE_TIMEOUT) {
+    return 0;
+  }
+
+  if (pModule != PLAYER_NO_CHECKSUM) {
+    printf("Variant: no answer, try without checksum\r\n");
+    pModule = PLAYER_NO_CHECKSUM;
+    player_query(PLAYER_GET_STATUS, 0);
+    vSince = scheduler_millis();
+    return 0;
+  }
+
+  // nothing answers, keep default & try again next boot
+  printf("Variant: not detected\r\n");
+  pModule = PLAYER_MINI;
+  vState = VARIANT_UNKNOWN;
+  return 1;
+}
+
+/**
+ * @brief Keep stored pacing close to learned one, call from player task
+ * NOTE:
+ *  - flash is written at most once per boot, on new variant or big pacing change
+ *  - erase & program stall CPU ~5 msec, USART1 bytes arriving meanwhile are lost,
+ *    so write waits for empty queue, no reply pending & no frame being received
+ */
+void variant_task() {
+  if (vState != VARIANT_KNOWN || vSaved) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < PLAYER_PACE_CLASSES && !vSave; i++) {
+    uint16_t stored = vRecord.reply[i];
+    uint16_t learned = pPace[i].reply;
+
+    if (pPace[i].samples < PLAYER_PACE_SAMPLES * 4) {
+      continue;
+    }
+    vSave = (stored == 0 || (learned > stored ? learned - stored : stored - learned) > VARIANT_RESAVE_DELTA);
+  }
+
+  if (vSave && player_idle() && rxPos == 0) {
+    variant_save();
+    vSave = 0;
+    vSaved = 1;
+  }
+}
@@ -0,0 +1,43 @@
+#ifndef _VARIANT_H
+#define _VARIANT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VARIANT_ENABLE
+#define VARIANT_ENABLE        0    // 1 = detect module variant at boot & keep it with learned pacing in flash, needs PLAYER_PACE_ENABLE 1
+#endif
+
+#define VARIANT_ADDRESS       (FLASH_BASE + 0x4000 - 64) // Last 64 byte flash page, excluded from FLASH in Ld/Link.ld
+#define VARIANT_MAGIC         0x4D503301 // "MP3" + record version
+#define VARIANT_SLOW_REPLY    300  // Query reply slower than this is GD3200B/MH2024K (HW-247A), msec
+#define VARIANT_PROBE_TIMEOUT 500  // Status answer timeout per checksum style, msec
+#define VARIANT_RESAVE_DELTA  40   // Learned reply latency change worth a flash write on next idle link, msec
+
+/* Detection steps */
+enum variant_state {
+  VARIANT_UNKNOWN,  // no valid record, detect after module is up
+  VARIANT_PROBE,    // status query sent with current checksum style
+  VARIANT_KNOWN,
+};
+
+/* Flash record, one 64 byte page */
+struct variant_record {
+  uint32_t magic;
+  uint8_t module;                       // enum player_module
+  uint8_t reserved[3];
+  uint16_t reply[PLAYER_PACE_CLASSES];  // learned reply latency per pace class, 0 = not measured
+  uint32_t check;                       // ~sum of words above
+};
+
+uint8_t variant_load();
+void variant_start();
+uint8_t variant_step();
+void variant_task();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <string.h>
+#include <ch32v00x.h>
+#include "display.h"
+#include "fonts.h"
+#include "icons.h"
+#include "canvas.h"
+#include "scheduler.h"
+#include "widget.h"
+
+#define WIDGET_BAR_PITCH  3 // volume bar 2 columns + 1 column gap
+
+/**
+ * @brief Read bound variable
+ */
+uint16_t widget_read(struct widget *widget) {
+  if (widget->size == 1) {
+    return *(const uint8_t *) widget->value;
+  }
+  return *(const uint16_t *) widget->value;
+}
+
+/**
+ * @brief Map bound variable to what is visible on screen
+ * NOTE:
+ *  - bars are compared by filled columns, so small value changes don't cause redraw
+ */
+uint16_t widget_state(struct widget *widget) {
+  uint16_t value;
+  uint16_t range;
+  uint8_t bars;
+
+  switch (widget->type) {
+    case WIDGET_NUMBER:
+    case WIDGET_NUMBER2X:
+    case WIDGET_ICON:
+      return widget_read(widget);
+
+    case WIDGET_PROGRESS:
+      value = widget_read(widget);
+      range = *widget->range;
+      if (range == 0) {
+        return 0;
+      }
+      if (value > range) {
+        value = range;
+      }
+      return (uint32_t) value * (widget->width - 2) / range;
+
+    case WIDGET_VOLUME:
+      value = widget_read(widget);
+      bars = widget->width / WIDGET_BAR_PITCH;
+      if (value > widget->max) {
+        value = widget->max;
+      }
+      return (uint32_t) value * bars / widget->max;
+
+    case WIDGET_LABEL:
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Render widget columns & send them to display
+ */
+void widget_draw(struct widget *widget, uint16_t state) {
+  uint8_t buffer[DISPLAY_WIDTH];
+  char buff[DISPLAY_WIDTH / 8 + 1];
+  uint8_t width = widget->width;
+  uint8_t bars;
+  struct canvas canvas;
+
+  clear(buffer, sizeof(buffer));
+
+  switch (widget->type) {
+    case WIDGET_LABEL:
+      // text() stops at line end, width is cut to display below
+      text((char *) widget->value, buffer);
+      width = strlen(widget->value) * 8;
+      break;
+
+    case WIDGET_NUMBER:
+    case WIDGET_NUMBER2X:
+      // right aligned, without sprintf() the widget layer links no formatter
+      buff[widget->max] = 0;
+      for (uint8_t d = widget->max; d > 0; d--) {
+        buff[d - 1] = (state > 0 || d == widget->max) ? '0' + state % 10 : ' ';
+        state /= 10;
+      }
+      if (widget->type == WIDGET_NUMBER) {
+        text(buff, buffer);
+        break;
+      }
+      // lower half goes from second half of buffer now, upper half is sent below
+      text2x(buff, buffer, buffer + DISPLAY_WIDTH / 2);
+      display_sendColumns(widget->page + 1, widget->x, buffer + DISPLAY_WIDTH / 2, width);
+      break;
+
+    case WIDGET_PROGRESS:
+      buffer[0] = 0x7E;
+      for (uint8_t p = 1; p < width - 1; p++) {
+        buffer[p] = (p <= state) ? 0x7E : 0x42;
+      }
+      buffer[width - 1] = 0x7E;
+      break;
+
+    case WIDGET_VOLUME:
+      bars = width / WIDGET_BAR_PITCH;
+      for (uint8_t b = 0; b < bars; b++) {
+        uint8_t height = 1 + (b * 7) / (bars > 1 ? bars - 1 : 1);
+        uint8_t column = (b < state) ? (0xFF << (8 - height)) : 0x80;
+        buffer[b * WIDGET_BAR_PITCH] = column;
+        buffer[b * WIDGET_BAR_PITCH + 1] = column;
+      }
+      break;
+
+    case WIDGET_ICON:
+      // line buffer as one page canvas at widget position, icon is clipped to screen
+      canvas.buffer = buffer;
+      canvas.width = DISPLAY_WIDTH - widget->x;
+      canvas.pages = 1;
+      canvas.x = widget->x;
+      canvas.y = widget->page * 8;
+      canvas_icon(&canvas, widget->x, widget->page * 8, state, CANVAS_OR);
+      break;
+  }
+
+  if (widget->x + width > DISPLAY_WIDTH) {
+    width = DISPLAY_WIDTH - widget->x;
+  }
+  display_sendColumns(widget->page, widget->x, buffer, width);
+}
+
+/**
+ * @brief Redraw widgets whose bound variable changed on screen
+ */
+void widget_update(struct widget *widgets, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    struct widget *widget = &widgets[i];
+    uint16_t state = widget_state(widget);
+
+    if (widget->dirty || state != widget->last) {
+      widget_draw(widget, state);
+      widget->last = state;
+      widget->dirty = 0;
+    }
+  }
+}
+
+/**
+ * @brief Force full redraw on next update, e.g. after other page was shown
+ */
+void widget_invalidate(struct widget *widgets, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    widgets[i].dirty = 1;
+  }
+}
+
+/**
+ * @brief Marquee source for plain text
+ */
+uint8_t marquee_text(const void *source, uint16_t skip, uint8_t *buffer, uint8_t size) {
+  return textPropFrom((char *) source, skip, buffer, size);
+}
+
+/**
+ * @brief Set marquee text
+ * NOTE:
+ *  - text must stay valid while shown, it is rendered again after hardware scroll is stopped
+ */
+void marquee_set(struct marquee *marquee, char *text) {
+  marquee_setSource(marquee, marquee_text, text, textPropWidth(text));
+}
+
+/**
+ * @brief Set marquee source & pick cheapest way to show it
+ * NOTE:
+ *  - source is rendered on demand, so compressed text never needs a RAM copy
+ */
+void marquee_setSource(struct marquee *marquee, marquee_render render, const void *source, uint16_t width) {
+  marquee->render = render;
+  marquee->source = source;
+  marquee->textWidth = width;
+  marquee->offset = 0;
+  marquee->started = scheduler_millis();
+  marquee->dirty = 1;
+
+  if (marquee->textWidth <= marquee->width) {
+    marquee->mode = MARQUEE_STATIC;
+  } else if (marquee->x == 0 && marquee->width == DISPLAY_WIDTH) {
+    marquee->mode = MARQUEE_HARDWARE;
+  } else {
+    marquee->mode = MARQUEE_SOFTWARE;
+  }
+}
+
+/**
+ * @brief Draw marquee, call from display task after other widgets of page
+ * NOTE:
+ *  - hardware mode: SSD1306 rotates MARQUEE_CHUNK columns of text & gap, next chunk after full turn;
+ *    another write stops scrolling, page is rewritten rotated by steps taken so far & scroll restarted
+ *  - software mode: moves one column per call
+ */
+void marquee_update(struct marquee *marquee) {
+  uint8_t buffer[DISPLAY_WIDTH];
+  uint16_t position;
+  uint16_t steps;
+  uint8_t x;
+
+  if (marquee->render == 0) {
+    return;
+  }
+
+  switch (marquee->mode) {
+    case MARQUEE_STATIC:
+      if (!marquee->dirty) {
+        return;
+      }
+      clear(buffer, sizeof(buffer));
+      marquee->render(marquee->source, 0, buffer, marquee->width);
+      display_sendColumns(marquee->page, marquee->x, buffer, marquee->width);
+      break;
+
+    case MARQUEE_HARDWARE:
+      // panel steps on its own frame clock, position follows from frame time set in display_init()
+      steps = (scheduler_millis() - marquee->started) * 1000UL / MARQUEE_STEP_USEC;
+      if (steps >= DISPLAY_WIDTH) {
+        // chunk is back where it started, show next one
+        marquee->offset += MARQUEE_CHUNK;
+        if (marquee->offset >= marquee->textWidth) {
+          marquee->offset = 0;
+        }
+        marquee->started = scheduler_millis();
+        marquee->dirty = 1;
+        steps = 0;
+      }
+      if (!marquee->dirty && display_scrolling()) {
+        return;
+      }
+      // GDDRAM copy as SSD1306 would hold it after steps, chunk column n at n - steps
+      clear(buffer, sizeof(buffer));
+      if (steps < MARQUEE_CHUNK) {
+        marquee->render(marquee->source, marquee->offset + steps, buffer, MARQUEE_CHUNK - steps);
+      }
+      if (steps > 0) {
+        marquee->render(marquee->source, marquee->offset, buffer + DISPLAY_WIDTH - steps,
+          (steps < MARQUEE_CHUNK) ? steps : MARQUEE_CHUNK);
+      }
+      display_sendColumns(marquee->page, 0, buffer, DISPLAY_WIDTH);
+      display_scroll(marquee->page, marquee->page, MARQUEE_INTERVAL);
+      break;
+
+    case MARQUEE_SOFTWARE:
+      // window into endless strip of text & gap
+      x = 0;
+      position = marquee->offset;
+      while (x < marquee->width) {
+        if (position < marquee->textWidth) {
+          x += marquee->render(marquee->source, position, buffer + x, marquee->width - x);
+          position = marquee->textWidth;
+          continue;
+        }
+        buffer[x++] = 0;
+        if (++position >= marquee->textWidth + MARQUEE_GAP) {
+          position = 0;
+        }
+      }
+      display_sendColumns(marquee->page, marquee->x, buffer, marquee->width);
+
+      marquee->offset++;
+      if (marquee->offset >= marquee->textWidth + MARQUEE_GAP) {
+        marquee->offset = 0;
+      }
+      break;
+  }
+
+  marquee->dirty = 0;
+}
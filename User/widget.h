@@ -0,0 +1,93 @@
+#ifndef _WIDGET_H
+#define _WIDGET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Widget types */
+enum widget_type {
+  WIDGET_LABEL,     // static text, value = char*
+  WIDGET_NUMBER,    // right aligned decimal, max = number of digits
+  WIDGET_NUMBER2X,  // same in 16x16 digits over page & page + 1, up to 4 digits
+  WIDGET_PROGRESS,  // horizontal bar, range = variable with 100% value
+  WIDGET_VOLUME,    // rising bars, max = 100% value
+  WIDGET_ICON,      // 8x8 icon, value = enum icon
+};
+
+/*
+ * Retained widget, bound to state variable
+ *  - last keeps what is on screen (digits value, filled columns, icon index),
+ *    widget is redrawn only when the bound variable maps to something else
+ *  - redraw touches only page/x/width of widget
+ */
+struct widget {
+  uint8_t type;
+  uint8_t page;         // 0..3
+  uint8_t x;            // first column 0..127
+  uint8_t width;        // columns
+  const void *value;    // bound variable
+  uint8_t size;         // sizeof bound variable, 1 or 2
+  uint16_t max;         // digits for number, 100% for volume
+  const uint16_t *range;// 100% for progress
+  uint16_t last;
+  uint8_t dirty;
+};
+
+#define WIDGET_LABEL_AT(page, column, text) \
+  { WIDGET_LABEL, page, (column) * 8, 0, text, 0, 0, 0, 0, 1 }
+#define WIDGET_NUMBER_AT(page, column, digits, var) \
+  { WIDGET_NUMBER, page, (column) * 8, (digits) * 8, &(var), sizeof(var), digits, 0, 0, 1 }
+#define WIDGET_NUMBER2X_AT(page, column, digits, var) \
+  { WIDGET_NUMBER2X, page, (column) * 8, (digits) * 16, &(var), sizeof(var), digits, 0, 0, 1 }
+#define WIDGET_PROGRESS_AT(page, x, width, var, range) \
+  { WIDGET_PROGRESS, page, x, width, &(var), sizeof(var), 0, &(range), 0, 1 }
+#define WIDGET_VOLUME_AT(page, x, width, var, max) \
+  { WIDGET_VOLUME, page, x, width, &(var), sizeof(var), max, 0, 0, 1 }
+#define WIDGET_ICON_AT(page, column, var) \
+  { WIDGET_ICON, page, (column) * 8, 8, &(var), sizeof(var), 0, 0, 0, 1 }
+
+/* Marquee modes, chosen by marquee_set() */
+enum marquee_mode {
+  MARQUEE_STATIC,   // text fits, drawn once
+  MARQUEE_HARDWARE, // full width page, SSD1306 scrolls chunks of text, page rewritten once per turn
+  MARQUEE_SOFTWARE, // partial width, redrawn per step
+};
+
+#define MARQUEE_GAP       24   // blank columns between end & start of text
+#define MARQUEE_INTERVAL  0x07 // hardware scroll step, see display_scroll()
+#define MARQUEE_FRAMES    2    // frames per step of MARQUEE_INTERVAL
+#define MARQUEE_STEP_USEC (DISPLAY_FRAME_USEC * MARQUEE_FRAMES) // time per hardware scroll step
+#define MARQUEE_CHUNK     (DISPLAY_WIDTH - MARQUEE_GAP) // text columns per hardware turn
+
+/* Marquee source, renders columns of its text starting at skip, returns used columns */
+typedef uint8_t (*marquee_render)(const void *source, uint16_t skip, uint8_t *buffer, uint8_t size);
+
+/* Single line of proportional text scrolling in page/x/width region */
+struct marquee {
+  uint8_t page;
+  uint8_t x;
+  uint8_t width;
+  marquee_render render;
+  const void *source;
+  uint16_t textWidth;
+  uint16_t offset;
+  uint32_t started;     // msec hardware turn started
+  uint8_t mode;
+  uint8_t dirty;
+};
+
+#define MARQUEE_AT(page, x, width) \
+  { page, x, width, 0, 0, 0, 0, 0, MARQUEE_STATIC, 1 }
+
+void widget_update(struct widget *widgets, uint8_t count);
+void widget_invalidate(struct widget *widgets, uint8_t count);
+void marquee_set(struct marquee *marquee, char *text);
+void marquee_setSource(struct marquee *marquee, marquee_render render, const void *source, uint16_t width);
+void marquee_update(struct marquee *marquee);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif